@@ -0,0 +1,3045 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <limits>
+#ifdef __linux__
+#include <pthread.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <sys/un.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#endif
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+
+// Hot-path latency instrumentation, enabled by compiling with
+// -DORDERBOOK_PROFILE. When disabled the probes expand to nothing, so the
+// counters cost nothing in production builds.
+#ifdef ORDERBOOK_PROFILE
+
+// Fixed-bucket latency histogram: bucket i counts samples in
+// [2^i, 2^(i+1)) nanoseconds, so recording is a shift loop and an
+// increment and percentile queries never sort anything
+class LatencyHistogram {
+private:
+    static const int bucketCount = 40;
+    uint64_t buckets[bucketCount];
+    uint64_t totalSamples;
+
+public:
+    LatencyHistogram() : buckets{}, totalSamples(0) {}
+
+    void record(uint64_t nanos) {
+        int bucket = 0;
+        while (nanos > 1 && bucket < bucketCount - 1) {
+            nanos >>= 1;
+            bucket++;
+        }
+        buckets[bucket]++;
+        totalSamples++;
+    }
+
+    // Returns an upper bound (bucket boundary) for the given percentile
+    uint64_t percentile(double p) const {
+        uint64_t target = static_cast<uint64_t>(totalSamples * p);
+        uint64_t seen = 0;
+        for (int i = 0; i < bucketCount; i++) {
+            seen += buckets[i];
+            if (seen >= target && buckets[i] > 0) {
+                return static_cast<uint64_t>(1) << (i + 1);
+            }
+        }
+        return 0;
+    }
+
+    uint64_t sampleCount() const {
+        return totalSamples;
+    }
+
+    void report(const char* name, std::ostream& out) const {
+        if (totalSamples == 0) {
+            return;
+        }
+        out << name << ": n=" << totalSamples
+            << " p50<=" << percentile(0.50)
+            << "ns p90<=" << percentile(0.90)
+            << "ns p99<=" << percentile(0.99)
+            << "ns p99.9<=" << percentile(0.999) << "ns" << std::endl;
+    }
+};
+
+// Owns the per-operation histograms and exports them periodically
+class Profiler {
+private:
+    uint64_t samplesSinceExport = 0;
+
+    // How many recorded samples between automatic exports
+    static const uint64_t exportInterval = 1 << 20;
+
+    Profiler() = default;
+
+public:
+    LatencyHistogram insertHistogram;
+    LatencyHistogram matchHistogram;
+    LatencyHistogram serialiseHistogram;
+
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    void exportHistograms(std::ostream& out) {
+        out << "--- latency histograms ---" << std::endl;
+        insertHistogram.report("insert", out);
+        matchHistogram.report("match", out);
+        serialiseHistogram.report("serialise", out);
+    }
+
+    void maybeExport() {
+        if (++samplesSinceExport >= exportInterval) {
+            samplesSinceExport = 0;
+            exportHistograms(std::cerr);
+        }
+    }
+};
+
+// RAII probe that records the enclosing scope's duration into a histogram
+class LatencyTimer {
+private:
+    LatencyHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit LatencyTimer(LatencyHistogram& histogram)
+        : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+
+    ~LatencyTimer() {
+        auto end = std::chrono::steady_clock::now();
+        histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        Profiler::instance().maybeExport();
+    }
+};
+
+#define ORDERBOOK_TIMER(histogram) LatencyTimer latencyTimer(Profiler::instance().histogram)
+#else
+#define ORDERBOOK_TIMER(histogram)
+#endif
+
+// Side of the book an order belongs to, stored as a single byte so Order
+// stays trivially copyable
+enum class Side : uint8_t {
+    BID = 0,
+    ASK = 1
+};
+
+// Returns the JSON/display name for a side
+inline const char* sideToString(Side side) {
+    return side == Side::ASK ? "ASK" : "BID";
+}
+
+// Fixed-point price on a compile-time tick grid. The book's integer prices
+// have always been tick counts; this wrapper makes the grid explicit and
+// carries it in the type, so fractional display prices convert to ticks
+// exactly once at the boundary and two prices on different grids cannot be
+// mixed by accident. All conversions divide or multiply by a constexpr
+// tick count, which the compiler strength-reduces to shifts when the grid
+// is a power of two, and the overflow guard is a constexpr predicate that
+// compiles out wherever the grid makes overflow impossible.
+template <long TicksPerUnit>
+class FixedPrice {
+    static_assert(TicksPerUnit > 0, "tick grid must be positive");
+
+    int64_t ticks;
+
+    constexpr explicit FixedPrice(int64_t ticks) : ticks(ticks) {}
+
+public:
+    static constexpr long ticksPerUnit = TicksPerUnit;
+
+    constexpr FixedPrice() : ticks(0) {}
+
+    static constexpr FixedPrice fromTicks(int64_t ticks) {
+        return FixedPrice(ticks);
+    }
+
+    static constexpr FixedPrice fromUnits(long units) {
+        return FixedPrice(static_cast<int64_t>(units) * TicksPerUnit);
+    }
+
+    // True when `units` whole units fit on this grid without overflow;
+    // constexpr, so guards against impossible overflows cost nothing
+    static constexpr bool canRepresentUnits(long units) {
+        return units >= 0 && static_cast<uint64_t>(units)
+            <= static_cast<uint64_t>(INT64_MAX) / static_cast<uint64_t>(TicksPerUnit);
+    }
+
+    constexpr int64_t rawTicks() const {
+        return ticks;
+    }
+
+    constexpr double toDouble() const {
+        return static_cast<double>(ticks) / static_cast<double>(TicksPerUnit);
+    }
+
+    // Direct ladder index relative to a base price: the division by the
+    // tick size happened at construction, so indexing a dense per-tick
+    // level array is a plain subtraction
+    constexpr int64_t indexFrom(FixedPrice base) const {
+        return ticks - base.ticks;
+    }
+
+    constexpr FixedPrice operator+(FixedPrice other) const { return FixedPrice(ticks + other.ticks); }
+    constexpr FixedPrice operator-(FixedPrice other) const { return FixedPrice(ticks - other.ticks); }
+    constexpr bool operator==(FixedPrice other) const { return ticks == other.ticks; }
+    constexpr bool operator!=(FixedPrice other) const { return ticks != other.ticks; }
+    constexpr bool operator<(FixedPrice other) const { return ticks < other.ticks; }
+    constexpr bool operator<=(FixedPrice other) const { return ticks <= other.ticks; }
+    constexpr bool operator>(FixedPrice other) const { return ticks > other.ticks; }
+    constexpr bool operator>=(FixedPrice other) const { return ticks >= other.ticks; }
+};
+
+// Fixed-point quantity on a compile-time lot grid; same idea as FixedPrice
+template <long UnitsPerLot>
+class FixedQuantity {
+    static_assert(UnitsPerLot > 0, "lot size must be positive");
+
+    int64_t units;
+
+    constexpr explicit FixedQuantity(int64_t units) : units(units) {}
+
+public:
+    static constexpr long unitsPerLot = UnitsPerLot;
+
+    constexpr FixedQuantity() : units(0) {}
+
+    static constexpr FixedQuantity fromUnits(int64_t units) {
+        return FixedQuantity(units);
+    }
+
+    static constexpr FixedQuantity fromLots(long lots) {
+        return FixedQuantity(static_cast<int64_t>(lots) * UnitsPerLot);
+    }
+
+    constexpr int64_t rawUnits() const {
+        return units;
+    }
+
+    constexpr int64_t wholeLots() const {
+        return units / UnitsPerLot;
+    }
+
+    constexpr FixedQuantity operator+(FixedQuantity other) const { return FixedQuantity(units + other.units); }
+    constexpr FixedQuantity operator-(FixedQuantity other) const { return FixedQuantity(units - other.units); }
+    constexpr bool operator==(FixedQuantity other) const { return units == other.units; }
+    constexpr bool operator!=(FixedQuantity other) const { return units != other.units; }
+    constexpr bool operator<(FixedQuantity other) const { return units < other.units; }
+    constexpr bool operator<=(FixedQuantity other) const { return units <= other.units; }
+    constexpr bool operator>(FixedQuantity other) const { return units > other.units; }
+    constexpr bool operator>=(FixedQuantity other) const { return units >= other.units; }
+};
+
+// The grid the engine currently runs on: one tick per displayed unit and
+// single-unit lots, matching the plain ints stored throughout the book.
+// Moving to a finer grid (e.g. FixedPrice<100> for cent ticks) is a
+// typedef change plus conversion at the input boundaries; the book's
+// internal ints stay tick counts either way.
+typedef FixedPrice<1> BookPrice;
+typedef FixedQuantity<1> BookQuantity;
+
+// Compile-time exercise of the grid arithmetic on non-trivial grids, so a
+// regression in the conversions fails the build rather than a harness run
+namespace fixed_point_checks {
+    typedef FixedPrice<100> CentPrice;
+    static_assert(CentPrice::fromUnits(101).rawTicks() == 10100, "unit conversion must scale by the grid");
+    static_assert((CentPrice::fromTicks(10125) - CentPrice::fromUnits(101)).rawTicks() == 25, "tick arithmetic must stay on the grid");
+    static_assert(CentPrice::fromUnits(2).indexFrom(CentPrice::fromUnits(1)) == 100, "ladder indexing must count ticks");
+    static_assert(CentPrice::fromTicks(99) < CentPrice::fromUnits(1), "comparisons must order by ticks");
+    static_assert(CentPrice::canRepresentUnits(INT64_MAX / 100), "grid overflow guard rejects representable values");
+    static_assert(!CentPrice::canRepresentUnits(INT64_MAX / 100 + 1), "grid overflow guard misses an overflow");
+
+    typedef FixedQuantity<10> TenLot;
+    static_assert(TenLot::fromLots(3).rawUnits() == 30, "lot conversion must scale by the lot size");
+    static_assert(TenLot::fromUnits(35).wholeLots() == 3, "whole lots must truncate toward zero");
+    static_assert((TenLot::fromLots(2) + TenLot::fromUnits(5)).rawUnits() == 25, "quantity arithmetic must stay in units");
+}
+
+// Order class which contains all details related to the order being placed.
+// Kept trivially copyable on purpose: no string members, so copying an order
+// never touches the heap.
+class Order {
+private:
+    Side side;      // Side of the book the order belongs to
+    int price;      // Price of the order
+    int quantity;   // Quantity of the order
+    int orderID;    // Unique order ID
+
+public:
+    Order() = default;
+    Order(Side side, int price, int quantity, int orderID) {
+        this->side = side;
+        this->price = price;
+        this->quantity = quantity;
+        this->orderID = orderID;
+    }
+    ~Order() = default;
+
+    // Getter methods for retrieving order details
+    int getPrice() const {
+        return price;
+    }
+
+    int getQuantity() const {
+        return quantity;
+    }
+
+    int getOrderID() const {
+        return orderID;
+    }
+
+    // Method to update the quantity of an order
+    void setQuantity(int newQuantity) {
+        this->quantity = newQuantity;
+    }
+
+    Side getSide() const {
+        return this->side;
+    }
+
+    // Formats the order as JSON into the caller's buffer — integer fields go
+    // through std::to_chars and nothing is heap-allocated. Returns the number
+    // of bytes written, or 0 if the buffer is too small.
+    size_t writeJSON(char* buffer, size_t capacity) const {
+        char* cursor = buffer;
+        char* end = buffer + capacity;
+
+        auto appendLiteral = [&](const char* text, size_t length) -> bool {
+            if (cursor == nullptr || cursor + length > end) {
+                cursor = nullptr;
+                return false;
+            }
+            std::memcpy(cursor, text, length);
+            cursor += length;
+            return true;
+        };
+        auto appendInt = [&](int value) -> bool {
+            if (cursor == nullptr) {
+                return false;
+            }
+            std::to_chars_result result = std::to_chars(cursor, end, value);
+            if (result.ec != std::errc()) {
+                cursor = nullptr;
+                return false;
+            }
+            cursor = result.ptr;
+            return true;
+        };
+
+        appendLiteral("{\"type\":\"", 9);
+        appendLiteral(sideToString(side), 3);  // "ASK" and "BID" are both 3 bytes
+        appendLiteral("\",\"price\":", 10);
+        appendInt(price);
+        appendLiteral(",\"quantity\":", 12);
+        appendInt(quantity);
+        appendLiteral(",\"orderID\":", 11);
+        appendInt(orderID);
+        if (!appendLiteral("}", 1)) {
+            return 0;
+        }
+        return cursor - buffer;
+    }
+};
+
+// Handle identifying an order's slot in the pool; the book structures move
+// these 4-byte values around instead of whole Order objects
+typedef uint32_t OrderHandle;
+
+// Preallocated arena the orders live in. Slots freed by fills and cancels
+// are recycled through a free list, so the steady-state hot path never
+// allocates.
+class OrderPool {
+private:
+    std::vector<Order> orders;
+    std::vector<OrderHandle> freeList;
+
+public:
+    OrderPool() {
+        // Reserve up front so inserts do not reallocate mid-session
+        orders.reserve(1 << 20);
+    }
+    ~OrderPool() = default;
+
+    OrderHandle allocate(const Order& order) {
+        if (!freeList.empty()) {
+            OrderHandle handle = freeList.back();
+            freeList.pop_back();
+            orders[handle] = order;
+            return handle;
+        }
+        orders.push_back(order);
+        return static_cast<OrderHandle>(orders.size() - 1);
+    }
+
+    void release(OrderHandle handle) {
+        freeList.push_back(handle);
+    }
+
+    Order& get(OrderHandle handle) {
+        return orders[handle];
+    }
+
+    const Order& get(OrderHandle handle) const {
+        return orders[handle];
+    }
+
+    // Slots ever handed out, including ones sitting on the free list
+    size_t slotCount() const {
+        return orders.size();
+    }
+
+    // Bytes backing the arena and its free list
+    size_t residentBytes() const {
+        return orders.capacity() * sizeof(Order) + freeList.capacity() * sizeof(OrderHandle);
+    }
+};
+
+// Manages the data of the order book as a price-level ladder: orders are
+// grouped into FIFO queues keyed by integer price, giving O(1) access to the
+// best bid/ask and correct price-time priority for same-price orders. The
+// ladder holds pool handles, not Order objects, so level operations shuffle
+// 4 bytes per order.
+class OrderBookData {
+public:
+    // FIFO of resting orders at a single price level, oldest order first
+    typedef std::deque<OrderHandle> PriceLevel;
+
+    // Asks are sorted with the lowest price first, bids with the highest first
+    typedef std::map<int, PriceLevel> AskLadder;
+    typedef std::map<int, PriceLevel, std::greater<int> > BidLadder;
+
+    // Records which side and price level a resting order lives at, so it can
+    // be located without walking the ladder
+    struct OrderLocation {
+        char side;  // 'A' for ask, 'B' for bid
+        int price;  // Price level the order rests at
+    };
+
+    // One aggregated price level returned by depth queries
+    struct DepthLevel {
+        int price;          // Price of the level
+        long totalQuantity; // Aggregate resting quantity at the level
+        int orderCount;     // Number of resting orders at the level
+    };
+
+    // Cached best bid/ask, maintained incrementally by the mutation paths
+    // so readers never re-derive the aggregate top-of-book quantities.
+    // Prices are 0 when the side is empty.
+    struct TopOfBook {
+        int bidPrice = 0;
+        long bidQuantity = 0;
+        int askPrice = 0;
+        long askQuantity = 0;
+
+        // Only meaningful when both sides are non-empty
+        int spread() const {
+            return askPrice - bidPrice;
+        }
+
+        bool operator==(const TopOfBook& other) const {
+            return bidPrice == other.bidPrice && bidQuantity == other.bidQuantity
+                && askPrice == other.askPrice && askQuantity == other.askQuantity;
+        }
+    };
+
+    typedef std::function<void(const TopOfBook&)> TopOfBookCallback;
+
+    // One journal entry per order touched since the last serialise. The op
+    // distinguishes orders the last snapshot has never seen ('A') from
+    // updates ('U') and removals ('R') of ones it has, so an order that is
+    // added and fully consumed within one interval nets out to nothing.
+    struct DirtyRecord {
+        char op;        // 'A' added, 'U' updated, 'R' removed
+        char side;      // 'A' for ask, 'B' for bid
+        int32_t price;
+        int32_t quantity;
+    };
+    typedef std::unordered_map<int, DirtyRecord> DirtyMap;
+
+    // Optional struct-of-arrays mirror of one side's resting orders:
+    // parallel contiguous arrays of price, quantity and order ID, so
+    // full-book analytics scans are linear streams the prefetcher and
+    // autovectoriser can chew through instead of pointer-chasing the
+    // ladder. Unordered — removal swaps the last entry into the hole.
+    struct SideArrays {
+        std::vector<int32_t> prices;
+        std::vector<int32_t> quantities;
+        std::vector<int32_t> orderIDs;
+        std::unordered_map<int, size_t> positions;  // orderID -> array slot
+
+        size_t size() const {
+            return prices.size();
+        }
+
+        void add(int price, int quantity, int orderID) {
+            positions[orderID] = prices.size();
+            prices.push_back(price);
+            quantities.push_back(quantity);
+            orderIDs.push_back(orderID);
+        }
+
+        void update(int orderID, int quantity) {
+            std::unordered_map<int, size_t>::iterator it = positions.find(orderID);
+            if (it != positions.end()) {
+                quantities[it->second] = quantity;
+            }
+        }
+
+        void remove(int orderID) {
+            std::unordered_map<int, size_t>::iterator it = positions.find(orderID);
+            if (it == positions.end()) {
+                return;
+            }
+            size_t slot = it->second;
+            size_t last = prices.size() - 1;
+            if (slot != last) {
+                prices[slot] = prices[last];
+                quantities[slot] = quantities[last];
+                orderIDs[slot] = orderIDs[last];
+                positions[orderIDs[slot]] = slot;
+            }
+            prices.pop_back();
+            quantities.pop_back();
+            orderIDs.pop_back();
+            positions.erase(it);
+        }
+    };
+
+private:
+    OrderPool orderPool;
+    AskLadder askLadder;
+    BidLadder bidLadder;
+    std::unordered_map<int, OrderLocation> orderIndex;
+    TopOfBook topOfBook;
+    std::vector<TopOfBookCallback> topCallbacks;
+    DirtyMap dirtyOrders;
+
+    // Struct-of-arrays mirrors, maintained only when analytics opts in so
+    // the matching hot path does not pay for them by default
+    bool analyticsArraysEnabled = false;
+    SideArrays askArrays;
+    SideArrays bidArrays;
+
+    void arraysAdd(char side, const Order& order) {
+        if (!analyticsArraysEnabled) {
+            return;
+        }
+        SideArrays& arrays = (side == 'A') ? askArrays : bidArrays;
+        arrays.add(order.getPrice(), order.getQuantity(), order.getOrderID());
+    }
+
+    void arraysUpdate(const Order& order) {
+        if (!analyticsArraysEnabled) {
+            return;
+        }
+        SideArrays& arrays = (order.getSide() == Side::ASK) ? askArrays : bidArrays;
+        arrays.update(order.getOrderID(), order.getQuantity());
+    }
+
+    void arraysRemove(char side, int orderID) {
+        if (!analyticsArraysEnabled) {
+            return;
+        }
+        SideArrays& arrays = (side == 'A') ? askArrays : bidArrays;
+        arrays.remove(orderID);
+    }
+
+    // Journals an insert; a re-add of an ID removed this interval (modify)
+    // becomes an update of the order the last snapshot knew
+    void markDirtyAdd(char side, int price, int quantity, int orderID) {
+        DirtyMap::iterator it = dirtyOrders.find(orderID);
+        if (it == dirtyOrders.end()) {
+            dirtyOrders.emplace(orderID, DirtyRecord{'A', side, price, quantity});
+        } else {
+            char op = (it->second.op == 'R') ? 'U' : it->second.op;
+            it->second = DirtyRecord{op, side, price, quantity};
+        }
+    }
+
+    // Journals an in-place quantity change to a resting order
+    void markDirtyUpdate(const Order& order) {
+        char side = (order.getSide() == Side::ASK) ? 'A' : 'B';
+        DirtyMap::iterator it = dirtyOrders.find(order.getOrderID());
+        if (it == dirtyOrders.end()) {
+            dirtyOrders.emplace(order.getOrderID(), DirtyRecord{'U', side, order.getPrice(), order.getQuantity()});
+        } else {
+            it->second.side = side;
+            it->second.price = order.getPrice();
+            it->second.quantity = order.getQuantity();
+        }
+    }
+
+    // Journals a removal; an order added this interval simply vanishes
+    void markDirtyRemoved(int orderID) {
+        DirtyMap::iterator it = dirtyOrders.find(orderID);
+        if (it != dirtyOrders.end()) {
+            if (it->second.op == 'A') {
+                dirtyOrders.erase(it);
+            } else {
+                it->second.op = 'R';
+            }
+        } else {
+            dirtyOrders.emplace(orderID, DirtyRecord{'R', '-', 0, 0});
+        }
+    }
+
+    // Erases an order from a price level's FIFO, dropping the level if it
+    // becomes empty. Returns true and fills removedOrder if the ID was found.
+    template <typename Ladder>
+    bool eraseFromLadder(Ladder& ladder, int price, int orderID, Order& removedOrder) {
+        typename Ladder::iterator levelIt = ladder.find(price);
+        if (levelIt == ladder.end()) {
+            return false;
+        }
+        PriceLevel& level = levelIt->second;
+        for (PriceLevel::iterator it = level.begin(); it != level.end(); ++it) {
+            if (orderPool.get(*it).getOrderID() == orderID) {
+                removedOrder = orderPool.get(*it);
+                orderPool.release(*it);
+                level.erase(it);
+                if (level.empty()) {
+                    ladder.erase(levelIt);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Fills `remaining` against the best level of a ladder front-to-back,
+    // releasing fully filled orders and dropping the level if it empties.
+    // Returns the quantity still unfilled. Used by executeImmediate.
+    template <typename Ladder, typename FillCallback>
+    int drainLevelFront(Ladder& ladder, int remaining, FillCallback onFill) {
+        typename Ladder::iterator levelIt = ladder.begin();
+        PriceLevel& level = levelIt->second;
+        while (remaining > 0 && !level.empty()) {
+            Order& resting = orderPool.get(level.front());
+            int matchedQuantity = std::min(remaining, resting.getQuantity());
+            resting.setQuantity(resting.getQuantity() - matchedQuantity);
+            remaining -= matchedQuantity;
+            onFill(resting, matchedQuantity);
+
+            if (resting.getQuantity() == 0) {
+                orderIndex.erase(resting.getOrderID());
+                markDirtyRemoved(resting.getOrderID());
+                arraysRemove((resting.getSide() == Side::ASK) ? 'A' : 'B', resting.getOrderID());
+                orderPool.release(level.front());
+                level.pop_front();
+            } else {
+                markDirtyUpdate(resting);
+                arraysUpdate(resting);
+            }
+        }
+        if (level.empty()) {
+            ladder.erase(levelIt);
+        }
+        return remaining;
+    }
+
+    // Recomputes the cached top from the best level of each side and fires
+    // the change callbacks only when something actually moved. Called by the
+    // mutation paths whenever the best level may have been touched.
+    void refreshTopOfBook() {
+        TopOfBook fresh;
+        if (!bidLadder.empty()) {
+            BidLadder::const_iterator best = bidLadder.begin();
+            fresh.bidPrice = best->first;
+            for (OrderHandle handle : best->second) {
+                fresh.bidQuantity += orderPool.get(handle).getQuantity();
+            }
+        }
+        if (!askLadder.empty()) {
+            AskLadder::const_iterator best = askLadder.begin();
+            fresh.askPrice = best->first;
+            for (OrderHandle handle : best->second) {
+                fresh.askQuantity += orderPool.get(handle).getQuantity();
+            }
+        }
+        if (fresh == topOfBook) {
+            return;
+        }
+        topOfBook = fresh;
+        for (const TopOfBookCallback& callback : topCallbacks) {
+            callback(topOfBook);
+        }
+    }
+
+public:
+    OrderBookData() = default;
+    ~OrderBookData() = default;
+
+    void addAskOrder(const Order& askOrder) {
+        askLadder[askOrder.getPrice()].push_back(orderPool.allocate(askOrder));
+        orderIndex[askOrder.getOrderID()] = OrderLocation{'A', askOrder.getPrice()};
+        markDirtyAdd('A', askOrder.getPrice(), askOrder.getQuantity(), askOrder.getOrderID());
+        arraysAdd('A', askOrder);
+        if (askLadder.begin()->first == askOrder.getPrice()) {
+            refreshTopOfBook();
+        }
+    }
+
+    void addBidOrder(const Order& bidOrder) {
+        bidLadder[bidOrder.getPrice()].push_back(orderPool.allocate(bidOrder));
+        orderIndex[bidOrder.getOrderID()] = OrderLocation{'B', bidOrder.getPrice()};
+        markDirtyAdd('B', bidOrder.getPrice(), bidOrder.getQuantity(), bidOrder.getOrderID());
+        arraysAdd('B', bidOrder);
+        if (bidLadder.begin()->first == bidOrder.getPrice()) {
+            refreshTopOfBook();
+        }
+    }
+
+    // Removes a resting order by ID using the index, so cancels do not need
+    // to drain and rebuild a whole side. Returns false if the ID is unknown.
+    bool removeOrder(int orderID, Order& removedOrder) {
+        std::unordered_map<int, OrderLocation>::iterator indexIt = orderIndex.find(orderID);
+        if (indexIt == orderIndex.end()) {
+            return false;
+        }
+        OrderLocation location = indexIt->second;
+        bool removed;
+        if (location.side == 'A') {
+            removed = eraseFromLadder(askLadder, location.price, orderID, removedOrder);
+        } else {
+            removed = eraseFromLadder(bidLadder, location.price, orderID, removedOrder);
+        }
+        if (removed) {
+            orderIndex.erase(indexIt);
+            markDirtyRemoved(orderID);
+            arraysRemove(location.side, orderID);
+            // Only a removal at the touch can move the top
+            if (location.side == 'A') {
+                if (askLadder.empty() || location.price <= askLadder.begin()->first) {
+                    refreshTopOfBook();
+                }
+            } else {
+                if (bidLadder.empty() || location.price >= bidLadder.begin()->first) {
+                    refreshTopOfBook();
+                }
+            }
+        }
+        return removed;
+    }
+
+    Order bestAskTop() {
+        return orderPool.get(askLadder.begin()->second.front());
+    }
+
+    Order bestBidTop() {
+        return orderPool.get(bidLadder.begin()->second.front());
+    }
+
+    void bestAskPop() {
+        PriceLevel& level = askLadder.begin()->second;
+        OrderHandle handle = level.front();
+        orderIndex.erase(orderPool.get(handle).getOrderID());
+        markDirtyRemoved(orderPool.get(handle).getOrderID());
+        arraysRemove('A', orderPool.get(handle).getOrderID());
+        orderPool.release(handle);
+        level.pop_front();
+        if (level.empty()) {
+            askLadder.erase(askLadder.begin());
+        }
+        refreshTopOfBook();
+    }
+
+    void bestBidPop() {
+        PriceLevel& level = bidLadder.begin()->second;
+        OrderHandle handle = level.front();
+        orderIndex.erase(orderPool.get(handle).getOrderID());
+        markDirtyRemoved(orderPool.get(handle).getOrderID());
+        arraysRemove('B', orderPool.get(handle).getOrderID());
+        orderPool.release(handle);
+        level.pop_front();
+        if (level.empty()) {
+            bidLadder.erase(bidLadder.begin());
+        }
+        refreshTopOfBook();
+    }
+
+    bool bestBidEmpty() {
+        return bidLadder.empty();
+    }
+
+    bool bestAskEmpty() {
+        return askLadder.empty();
+    }
+
+    const AskLadder& getAskLadder() const {
+        return askLadder;
+    }
+
+    const BidLadder& getBidLadder() const {
+        return bidLadder;
+    }
+
+    // Resolves a ladder handle back to the pooled order
+    const Order& getOrder(OrderHandle handle) const {
+        return orderPool.get(handle);
+    }
+
+    // Sweep-style match kernel: walks all resting orders at each crossing
+    // price level in one pass, filling in place via pool references. Orders
+    // are only erased when fully filled, so a partial fill never pays a
+    // pop/re-push cycle, and the level itself is dropped once, when empty.
+    // Calls onFill(ask, bid, matchedQuantity) after quantities are updated.
+    template <typename FillCallback>
+    void matchCrossing(FillCallback onFill) {
+        while (!askLadder.empty() && !bidLadder.empty()) {
+            AskLadder::iterator askIt = askLadder.begin();
+            BidLadder::iterator bidIt = bidLadder.begin();
+            if (askIt->first > bidIt->first) {
+                break;  // Best bid no longer crosses the best ask
+            }
+            PriceLevel& askLevel = askIt->second;
+            PriceLevel& bidLevel = bidIt->second;
+
+            while (!askLevel.empty() && !bidLevel.empty()) {
+                Order& ask = orderPool.get(askLevel.front());
+                Order& bid = orderPool.get(bidLevel.front());
+                int matchedQuantity = std::min(ask.getQuantity(), bid.getQuantity());
+                ask.setQuantity(ask.getQuantity() - matchedQuantity);
+                bid.setQuantity(bid.getQuantity() - matchedQuantity);
+                onFill(ask, bid, matchedQuantity);
+
+                if (ask.getQuantity() == 0) {
+                    orderIndex.erase(ask.getOrderID());
+                    markDirtyRemoved(ask.getOrderID());
+                    arraysRemove('A', ask.getOrderID());
+                    orderPool.release(askLevel.front());
+                    askLevel.pop_front();
+                } else {
+                    markDirtyUpdate(ask);
+                    arraysUpdate(ask);
+                }
+                if (bid.getQuantity() == 0) {
+                    orderIndex.erase(bid.getOrderID());
+                    markDirtyRemoved(bid.getOrderID());
+                    arraysRemove('B', bid.getOrderID());
+                    orderPool.release(bidLevel.front());
+                    bidLevel.pop_front();
+                } else {
+                    markDirtyUpdate(bid);
+                    arraysUpdate(bid);
+                }
+            }
+
+            if (askLevel.empty()) {
+                askLadder.erase(askIt);
+            }
+            if (bidLevel.empty()) {
+                bidLadder.erase(bidIt);
+            }
+        }
+        refreshTopOfBook();
+    }
+
+    // Total opposite-side quantity available to an order at this limit,
+    // used by fill-or-kill to decide before touching anything
+    long availableQuantity(Side side, int limitPrice) const {
+        long available = 0;
+        if (side == Side::BID) {
+            for (AskLadder::const_iterator it = askLadder.begin();
+                 it != askLadder.end() && it->first <= limitPrice; ++it) {
+                for (OrderHandle handle : it->second) {
+                    available += orderPool.get(handle).getQuantity();
+                }
+            }
+        } else {
+            for (BidLadder::const_iterator it = bidLadder.begin();
+                 it != bidLadder.end() && it->first >= limitPrice; ++it) {
+                for (OrderHandle handle : it->second) {
+                    available += orderPool.get(handle).getQuantity();
+                }
+            }
+        }
+        return available;
+    }
+
+    // Executes an incoming order against the opposite side in place without
+    // ever inserting it into the book, draining crossing levels best-price
+    // first. Calls onFill(restingOrder, matchedQuantity) per fill and
+    // returns the quantity actually filled.
+    template <typename FillCallback>
+    int executeImmediate(Side side, int limitPrice, int quantity, FillCallback onFill) {
+        int remaining = quantity;
+        if (side == Side::BID) {
+            while (remaining > 0 && !askLadder.empty() && askLadder.begin()->first <= limitPrice) {
+                remaining = drainLevelFront(askLadder, remaining, onFill);
+            }
+        } else {
+            while (remaining > 0 && !bidLadder.empty() && bidLadder.begin()->first >= limitPrice) {
+                remaining = drainLevelFront(bidLadder, remaining, onFill);
+            }
+        }
+        if (remaining != quantity) {
+            refreshTopOfBook();
+        }
+        return quantity - remaining;
+    }
+
+    // Opts in to the struct-of-arrays mirrors and builds them from the
+    // current book; the mutation paths keep them in sync from then on
+    void enableAnalyticsArrays() {
+        if (analyticsArraysEnabled) {
+            return;
+        }
+        analyticsArraysEnabled = true;
+        for (const auto& level : askLadder) {
+            for (OrderHandle handle : level.second) {
+                arraysAdd('A', orderPool.get(handle));
+            }
+        }
+        for (const auto& level : bidLadder) {
+            for (OrderHandle handle : level.second) {
+                arraysAdd('B', orderPool.get(handle));
+            }
+        }
+    }
+
+    // Contiguous price/quantity/orderID arrays for analytics scans; empty
+    // unless enableAnalyticsArrays has been called
+    const SideArrays& getAskArrays() const {
+        return askArrays;
+    }
+
+    const SideArrays& getBidArrays() const {
+        return bidArrays;
+    }
+
+    // Volume-weighted average price of one side's resting orders. With the
+    // arrays enabled this is a single linear pass over two contiguous
+    // vectors; otherwise it falls back to walking the ladder.
+    double volumeWeightedAveragePrice(Side side) const {
+        long notional = 0;
+        long volume = 0;
+        if (analyticsArraysEnabled) {
+            const SideArrays& arrays = (side == Side::ASK) ? askArrays : bidArrays;
+            for (size_t i = 0; i < arrays.size(); i++) {
+                notional += static_cast<long>(arrays.prices[i]) * arrays.quantities[i];
+                volume += arrays.quantities[i];
+            }
+        } else if (side == Side::ASK) {
+            for (const auto& level : askLadder) {
+                for (OrderHandle handle : level.second) {
+                    const Order& order = orderPool.get(handle);
+                    notional += static_cast<long>(order.getPrice()) * order.getQuantity();
+                    volume += order.getQuantity();
+                }
+            }
+        } else {
+            for (const auto& level : bidLadder) {
+                for (OrderHandle handle : level.second) {
+                    const Order& order = orderPool.get(handle);
+                    notional += static_cast<long>(order.getPrice()) * order.getQuantity();
+                    volume += order.getQuantity();
+                }
+            }
+        }
+        return (volume == 0) ? 0.0 : static_cast<double>(notional) / static_cast<double>(volume);
+    }
+
+    // Orders touched since the last clearDirtyOrders, for incremental
+    // serialisation; cost of walking it is proportional to recent churn,
+    // not to the number of resting orders
+    const DirtyMap& getDirtyOrders() const {
+        return dirtyOrders;
+    }
+
+    // Called once the journal has been persisted (or is known to be
+    // redundant, e.g. right after a bulk load from a snapshot)
+    void clearDirtyOrders() {
+        dirtyOrders.clear();
+    }
+
+    // Number of resting orders across both sides
+    size_t getOrderCount() const {
+        return orderIndex.size();
+    }
+
+    // Memory and occupancy telemetry, for alarming before the book blows
+    // through its budget
+    struct MemoryStats {
+        size_t askOrders;     // Resting orders on the ask side
+        size_t bidOrders;     // Resting orders on the bid side
+        size_t askLevels;     // Price levels on the ask side
+        size_t bidLevels;     // Price levels on the bid side
+        size_t poolSlots;     // Arena slots ever handed out (live + free list)
+        size_t residentBytes; // Approximate bytes across pool, ladders and index
+    };
+
+    // Resting orders on one side; walks levels, not orders
+    size_t sideOrderCount(Side side) const {
+        size_t count = 0;
+        if (side == Side::ASK) {
+            for (const auto& level : askLadder) {
+                count += level.second.size();
+            }
+        } else {
+            for (const auto& level : bidLadder) {
+                count += level.second.size();
+            }
+        }
+        return count;
+    }
+
+    MemoryStats getMemoryStats() const {
+        MemoryStats stats;
+        stats.askOrders = sideOrderCount(Side::ASK);
+        stats.bidOrders = sideOrderCount(Side::BID);
+        stats.askLevels = askLadder.size();
+        stats.bidLevels = bidLadder.size();
+        stats.poolSlots = orderPool.slotCount();
+        stats.residentBytes = orderPool.residentBytes()
+            + (stats.askOrders + stats.bidOrders) * sizeof(OrderHandle)
+            + (stats.askLevels + stats.bidLevels) * (sizeof(int) + sizeof(PriceLevel))
+            + orderIndex.size() * (sizeof(int) + sizeof(OrderLocation) + sizeof(void*));
+        return stats;
+    }
+
+    // ID of the lowest-priority resting order on a side: the youngest order
+    // at the worst price level. Returns 0 when the side is empty. Used by
+    // the capacity-eviction policy.
+    int worstOrderID(Side side) const {
+        if (side == Side::ASK) {
+            if (askLadder.empty()) {
+                return 0;
+            }
+            return orderPool.get(askLadder.rbegin()->second.back()).getOrderID();
+        }
+        if (bidLadder.empty()) {
+            return 0;
+        }
+        return orderPool.get(bidLadder.rbegin()->second.back()).getOrderID();
+    }
+
+    // Price of the worst level on a side; 0 when empty
+    int worstPrice(Side side) const {
+        if (side == Side::ASK) {
+            return askLadder.empty() ? 0 : askLadder.rbegin()->first;
+        }
+        return bidLadder.empty() ? 0 : bidLadder.rbegin()->first;
+    }
+
+    // Cheap cached read of the current best bid/ask and aggregate sizes
+    const TopOfBook& getTopOfBook() const {
+        return topOfBook;
+    }
+
+    // Registers a callback fired only when the top of book actually changes
+    void onTopOfBookChange(const TopOfBookCallback& callback) {
+        topCallbacks.push_back(callback);
+    }
+
+    // Returns the top `levels` aggregated price levels for a side without
+    // copying or mutating the book
+    std::vector<DepthLevel> getDepth(Side side, int levels) const {
+        std::vector<DepthLevel> depth;
+        depth.reserve(levels);
+        if (side == Side::ASK) {
+            aggregateDepth(askLadder, levels, depth);
+        } else {
+            aggregateDepth(bidLadder, levels, depth);
+        }
+        return depth;
+    }
+
+private:
+    // Walks a ladder best-price-first, summing resting quantity per level
+    template <typename Ladder>
+    void aggregateDepth(const Ladder& ladder, int levels, std::vector<DepthLevel>& depth) const {
+        for (typename Ladder::const_iterator levelIt = ladder.begin();
+             levelIt != ladder.end() && static_cast<int>(depth.size()) < levels; ++levelIt) {
+            DepthLevel depthLevel;
+            depthLevel.price = levelIt->first;
+            depthLevel.totalQuantity = 0;
+            depthLevel.orderCount = static_cast<int>(levelIt->second.size());
+            for (OrderHandle handle : levelIt->second) {
+                depthLevel.totalQuantity += orderPool.get(handle).getQuantity();
+            }
+            depth.push_back(depthLevel);
+        }
+    }
+};
+
+// Published, read-mostly view of one book for market-data and risk readers
+// running off the matching thread. The top-of-book is seqlock-protected and
+// depth snapshots are double-buffered and swapped by index, so readers never
+// take a lock the matcher can contend on and the matcher never blocks on a
+// slow reader: a reader that loses the race against a publish simply
+// retries its copy. Single writer — publish() must only be called from the
+// thread that mutates the book.
+class MarketDataView {
+public:
+    // Levels captured per side; fixed so a snapshot is trivially copyable
+    // and a reader's copy under the seqlock is a plain memcpy
+    static const int maxDepthLevels = 32;
+
+    struct DepthSnapshot {
+        OrderBookData::DepthLevel bids[maxDepthLevels];
+        OrderBookData::DepthLevel asks[maxDepthLevels];
+        int bidLevels = 0;
+        int askLevels = 0;
+        uint64_t sequence = 0;  // Publication count, for staleness checks
+    };
+
+private:
+    // Seqlock for the top-of-book: odd while a publish is rewriting it
+    std::atomic<uint64_t> topVersion{0};
+    OrderBookData::TopOfBook top;
+
+    // Depth is written into the buffer readers are not pointed at, then the
+    // published index is swapped. Each buffer carries its own version so a
+    // reader that held the old index across two publishes detects the
+    // rewrite underneath it and retries.
+    DepthSnapshot depthBuffers[2];
+    std::atomic<uint64_t> depthVersions[2];
+    std::atomic<int> publishedIndex{0};
+    uint64_t publishCount = 0;
+
+    // Fills one side of a snapshot straight from the ladder — no vector
+    // allocation on the matching thread
+    template <typename Ladder>
+    static int fillDepth(const OrderBookData& data, const Ladder& ladder,
+                         OrderBookData::DepthLevel* levels) {
+        int count = 0;
+        for (typename Ladder::const_iterator levelIt = ladder.begin();
+             levelIt != ladder.end() && count < maxDepthLevels; ++levelIt) {
+            long totalQuantity = 0;
+            for (OrderHandle handle : levelIt->second) {
+                totalQuantity += data.getOrder(handle).getQuantity();
+            }
+            levels[count] = OrderBookData::DepthLevel{
+                levelIt->first, totalQuantity, static_cast<int>(levelIt->second.size())};
+            count++;
+        }
+        return count;
+    }
+
+public:
+    MarketDataView() {
+        depthVersions[0].store(0);
+        depthVersions[1].store(0);
+    }
+
+    // Called by the matching thread after it finishes a batch of mutations
+    void publish(const OrderBookData& data) {
+        publishCount++;
+
+        // Seqlock write: bump to odd, rewrite, bump back to even
+        topVersion.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        top = data.getTopOfBook();
+        std::atomic_thread_fence(std::memory_order_release);
+        topVersion.fetch_add(1, std::memory_order_release);
+
+        int next = 1 - publishedIndex.load(std::memory_order_relaxed);
+        depthVersions[next].fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        DepthSnapshot& buffer = depthBuffers[next];
+        buffer.bidLevels = fillDepth(data, data.getBidLadder(), buffer.bids);
+        buffer.askLevels = fillDepth(data, data.getAskLadder(), buffer.asks);
+        buffer.sequence = publishCount;
+        std::atomic_thread_fence(std::memory_order_release);
+        depthVersions[next].fetch_add(1, std::memory_order_release);
+        publishedIndex.store(next, std::memory_order_release);
+    }
+
+    // Consistent copy of the top-of-book; retries if a publish raced it
+    OrderBookData::TopOfBook readTopOfBook() const {
+        OrderBookData::TopOfBook copy;
+        uint64_t before;
+        do {
+            before = topVersion.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;  // A publish is mid-rewrite
+            }
+            copy = top;
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while (topVersion.load(std::memory_order_relaxed) != before);
+        return copy;
+    }
+
+    // Consistent copy of the latest published depth snapshot
+    DepthSnapshot readDepth() const {
+        DepthSnapshot copy;
+        for (;;) {
+            int index = publishedIndex.load(std::memory_order_acquire);
+            uint64_t before = depthVersions[index].load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+            copy = depthBuffers[index];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (depthVersions[index].load(std::memory_order_relaxed) == before) {
+                return copy;
+            }
+        }
+    }
+};
+
+// Lock-free single-producer/single-consumer ring buffer carrying fixed-size
+// commands between an intake thread and a matching thread
+template <typename T>
+class SPSCQueue {
+private:
+    // Power of two so wrapping the indices is a mask, not a modulo
+    static const size_t capacity = 1 << 16;
+
+    std::vector<T> buffer;
+    std::atomic<size_t> head;  // Next slot the consumer reads
+    std::atomic<size_t> tail;  // Next slot the producer writes
+
+public:
+    SPSCQueue() : buffer(capacity), head(0), tail(0) {}
+    ~SPSCQueue() = default;
+
+    // Producer side; returns false when the ring is full
+    bool tryPush(const T& command) {
+        size_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail - head.load(std::memory_order_acquire) == capacity) {
+            return false;
+        }
+        buffer[currentTail & (capacity - 1)] = command;
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; returns false when the ring is empty
+    bool tryPop(T& command) {
+        size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        command = buffer[currentHead & (capacity - 1)];
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+};
+
+// One fill, recorded as a fixed-size binary record in the execution stream
+struct ExecutionReport {
+    uint64_t timestampNanos;  // steady_clock time of the fill
+    int32_t askOrderID;       // Ask side of the match
+    int32_t bidOrderID;       // Bid side of the match
+    int32_t price;            // Execution price
+    int32_t quantity;         // Quantity filled
+};
+
+// Preallocated ring of execution reports published by the match paths and
+// drained by downstream consumers. Matching never blocks on a slow reader:
+// fills that overrun the ring are counted as dropped, not waited on.
+class ExecutionReportStream {
+private:
+    SPSCQueue<ExecutionReport> ring;
+    std::atomic<uint64_t> droppedFills;
+
+public:
+    ExecutionReportStream() : droppedFills(0) {}
+    ~ExecutionReportStream() = default;
+
+    void publish(int askOrderID, int bidOrderID, int price, int quantity) {
+        ExecutionReport report;
+        report.timestampNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        report.askOrderID = askOrderID;
+        report.bidOrderID = bidOrderID;
+        report.price = price;
+        report.quantity = quantity;
+        if (!ring.tryPush(report)) {
+            droppedFills.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer side: pops one report if available
+    bool poll(ExecutionReport& report) {
+        return ring.tryPop(report);
+    }
+
+    uint64_t getDroppedFills() const {
+        return droppedFills.load(std::memory_order_relaxed);
+    }
+
+    // Optional slow consumer: drains the ring and pretty-prints each fill
+    void drainToConsole() {
+        ExecutionReport report;
+        while (ring.tryPop(report)) {
+            std::cout << "Matched: Ask Order ID " << report.askOrderID
+                      << " with Bid Order ID " << report.bidOrderID
+                      << ", Quantity " << report.quantity
+                      << ", Price " << report.price << std::endl;
+        }
+    }
+};
+
+// Used to serialise and deserialise the orderbook implemented as a singleton class
+class SerialisationService {
+public:
+    // Event types recorded in the append-only event log
+    enum EventType : uint8_t {
+        EVENT_ORDER_ADD = 0,
+        EVENT_TRADE = 1,
+        EVENT_CANCEL = 2
+    };
+
+    // Fixed-size record appended to the event log for each mutation
+    struct EventRecord {
+        uint8_t eventType;  // One of the EventType values
+        char side;          // 'A' for ask, 'B' for bid, '-' when not applicable
+        int32_t price;      // Price of the order or trade
+        int32_t quantity;   // Quantity added, traded or cancelled
+        int32_t orderID;    // Order the event refers to
+    };
+
+    // Fixed-width record stored per resting order in the binary snapshot
+    struct SnapshotRecord {
+        char side;          // 'A' for ask, 'B' for bid
+        int32_t price;      // Price of the order
+        int32_t quantity;   // Quantity of the order
+        int32_t orderID;    // Unique order ID
+    };
+
+    // Record appended to the snapshot delta log by incremental serialises;
+    // recovery applies these on top of the base snapshot in order
+    struct DeltaRecord {
+        char op;                // 'U' upsert, 'R' remove
+        SnapshotRecord record;  // Order state; only orderID is used for 'R'
+    };
+
+    // Header at the front of the binary snapshot file
+    struct SnapshotHeader {
+        uint32_t magic;     // Identifies the file as an order book snapshot
+        uint32_t version;   // Snapshot format version
+        uint64_t orderCount;// Number of SnapshotRecords that follow
+    };
+
+    // On-disk state of the order ID sequencer, rewritten atomically on
+    // every block reservation
+    struct SequencerRecord {
+        uint64_t reservedThrough;  // Highest order ID any process may have used
+        uint32_t epoch;            // Bumped once per process start
+        uint32_t reserved;         // Padding for future use
+    };
+
+    static const uint32_t snapshotMagic = 0x4F42534E;  // "NSBO" little-endian
+    static const uint32_t snapshotVersion = 1;
+
+private:
+    static SerialisationService *uniqueInstance;
+    static std::mutex mtx;
+    std::string filename;
+    std::string snapshotFilename;
+    std::string eventLogFilename;
+    std::string deltaFilename;
+    std::string sequencerFilename;
+    std::ofstream eventLog;
+    std::ofstream deltaLog;
+    int eventsSinceSnapshot;
+    long deltaRecordsWritten;  // Records in the delta log since the last full serialise
+    bool persistenceEnabled;
+
+    // Order ID sequencer state; see reserveOrderIDBlock
+    uint64_t idReservedThrough;
+    uint32_t idEpoch;
+    bool sequencerLoaded;
+
+    // Async persistence pipeline: mutations are queued and a dedicated
+    // writer thread batches them to disk, so disk latency costs queue depth
+    // rather than matching latency. Bounded: producers block when the queue
+    // is full rather than dropping events.
+    bool asyncPersistence;
+    std::deque<EventRecord> pendingEvents;
+    std::mutex pendingMutex;
+    std::condition_variable pendingCond;  // Signalled when events arrive
+    std::condition_variable spaceCond;    // Signalled when space frees up
+    std::mutex logFileMutex;              // Guards eventLog between writer and snapshot
+    std::thread writerThread;
+    std::atomic<bool> writerRunning;
+    int flushIntervalMillis;
+    static const size_t maxPendingEvents = 1 << 16;
+
+    // Writer thread body: wake on new events or the flush interval, swap
+    // the pending batch out under the lock, then write it with none held
+    void writerLoop() {
+        std::vector<EventRecord> batch;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(pendingMutex);
+                pendingCond.wait_for(lock, std::chrono::milliseconds(flushIntervalMillis),
+                                     [this] { return !pendingEvents.empty() || !writerRunning.load(); });
+                if (pendingEvents.empty() && !writerRunning.load()) {
+                    return;
+                }
+                batch.assign(pendingEvents.begin(), pendingEvents.end());
+                pendingEvents.clear();
+            }
+            spaceCond.notify_all();
+            if (!batch.empty()) {
+                std::lock_guard<std::mutex> fileLock(logFileMutex);
+                eventLog.write(reinterpret_cast<const char*>(batch.data()), batch.size() * sizeof(EventRecord));
+                eventLog.flush();
+                batch.clear();
+            }
+        }
+    }
+
+    void startWriter() {
+        writerRunning.store(true);
+        writerThread = std::thread(&SerialisationService::writerLoop, this);
+    }
+
+    void stopWriter() {
+        writerRunning.store(false);
+        pendingCond.notify_all();
+        if (writerThread.joinable()) {
+            writerThread.join();
+        }
+    }
+
+    // Number of logged events after which a full snapshot is taken; lower
+    // values bound recovery time more tightly at the cost of more snapshots
+    int snapshotInterval = 1024;
+
+    // Named instances let each instrument persist to its own files; the
+    // default name keeps the original single-book file layout
+    SerialisationService(const std::string& name, bool async) {
+        this->filename = name + "_data.json";
+        this->snapshotFilename = name + "_data.bin";
+        this->eventLogFilename = name + "_events.bin";
+        this->deltaFilename = name + "_delta.bin";
+        this->sequencerFilename = name + "_seq.bin";
+        this->eventsSinceSnapshot = 0;
+        this->deltaRecordsWritten = 0;
+        this->idReservedThrough = 0;
+        this->idEpoch = 0;
+        this->sequencerLoaded = false;
+        this->persistenceEnabled = true;
+        this->asyncPersistence = async;
+        this->flushIntervalMillis = 10;
+        this->writerRunning.store(false);
+        eventLog.open(eventLogFilename, std::ios::binary | std::ios::app);
+        deltaLog.open(deltaFilename, std::ios::binary | std::ios::app);
+        if (async) {
+            startWriter();
+        }
+    }
+    SerialisationService() : SerialisationService("orderbook", true) {}
+
+public:
+    SerialisationService(const SerialisationService &) = delete;
+    SerialisationService &operator=(const SerialisationService &) = delete;
+
+    // Named instances are owned by whoever created them (the global
+    // singleton is never destroyed); stopping the writer is a no-op for the
+    // synchronous streams the shards use
+    ~SerialisationService() {
+        stopWriter();
+    }
+
+    static SerialisationService *getInstance() {
+        if (uniqueInstance == nullptr)
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (uniqueInstance == nullptr)
+            {
+                uniqueInstance = new SerialisationService();
+            }
+        }
+        return uniqueInstance;
+    }
+
+    // Creates a persistence stream for one instrument. Named streams stay in
+    // synchronous mode so their owning shard thread does its own I/O instead
+    // of spawning a writer thread per symbol.
+    static SerialisationService *createNamed(const std::string& name) {
+        return new SerialisationService("orderbook_" + name, false);
+    }
+
+    // Turns persistence off entirely, for benchmarks and tests that must
+    // not touch the on-disk book
+    void setPersistenceEnabled(bool enabled) {
+        this->persistenceEnabled = enabled;
+    }
+
+    // Switches between the async writer-thread pipeline (default) and the
+    // synchronous inline path (--sync-persist, for testing). Intended to be
+    // called at startup, before order flow begins.
+    void setAsyncPersistence(bool enabled) {
+        if (enabled == asyncPersistence) {
+            return;
+        }
+        if (enabled) {
+            asyncPersistence = true;
+            startWriter();
+        } else {
+            stopWriter();
+            asyncPersistence = false;
+        }
+    }
+
+    void setFlushIntervalMillis(int millis) {
+        this->flushIntervalMillis = millis;
+    }
+
+    // Records a single fixed-size event. In async mode the record is queued
+    // for the writer thread (blocking only if the queue is full); in sync
+    // mode it is written and flushed inline.
+    void logEvent(EventType eventType, char side, int price, int quantity, int orderID) {
+        if (!persistenceEnabled) {
+            return;
+        }
+        EventRecord record;
+        record.eventType = eventType;
+        record.side = side;
+        record.price = price;
+        record.quantity = quantity;
+        record.orderID = orderID;
+
+        if (asyncPersistence) {
+            {
+                std::unique_lock<std::mutex> lock(pendingMutex);
+                spaceCond.wait(lock, [this] { return pendingEvents.size() < maxPendingEvents; });
+                pendingEvents.push_back(record);
+            }
+            pendingCond.notify_one();
+        } else {
+            std::lock_guard<std::mutex> fileLock(logFileMutex);
+            eventLog.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            eventLog.flush();
+        }
+        eventsSinceSnapshot++;
+    }
+
+    // Persists the current book state and resets the event log, so the log
+    // only ever holds events newer than the latest snapshot. When the set of
+    // orders touched since the last snapshot is small relative to the book,
+    // only that delta is appended to the delta log; a full rewrite happens
+    // when the accumulated delta would outgrow the base snapshot. After a
+    // quiet period the cost is proportional to the churn, not the book.
+    void snapshot(OrderBookData& orderBookData) {
+        if (!persistenceEnabled) {
+            return;
+        }
+        // A snapshot captures the full book state, so any events still
+        // queued for the writer are superseded and can be dropped
+        if (asyncPersistence) {
+            {
+                std::lock_guard<std::mutex> lock(pendingMutex);
+                pendingEvents.clear();
+            }
+            spaceCond.notify_all();
+        }
+        const OrderBookData::DirtyMap& dirty = orderBookData.getDirtyOrders();
+        bool incremental = deltaRecordsWritten + static_cast<long>(dirty.size())
+                < static_cast<long>(orderBookData.getOrderCount());
+        if (incremental) {
+            serialiseIncremental(dirty);
+        } else {
+            serialise(orderBookData);
+            deltaLog.close();
+            deltaLog.open(deltaFilename, std::ios::binary | std::ios::trunc);
+            deltaRecordsWritten = 0;
+        }
+        orderBookData.clearDirtyOrders();
+        {
+            std::lock_guard<std::mutex> fileLock(logFileMutex);
+            eventLog.close();
+            eventLog.open(eventLogFilename, std::ios::binary | std::ios::trunc);
+        }
+        eventsSinceSnapshot = 0;
+    }
+
+    // Takes a snapshot only once enough events have accumulated
+    void maybeSnapshot(OrderBookData& orderBookData) {
+        if (eventsSinceSnapshot >= snapshotInterval) {
+            snapshot(orderBookData);
+        }
+    }
+
+    // Writes the book as a binary snapshot: a header followed by fixed-width
+    // records, so loading never has to parse text. Written to a temporary
+    // file, fsynced and renamed into place, so a crash mid-write can never
+    // destroy the previous snapshot.
+    void serialise(const OrderBookData& orderBookData) {
+        ORDERBOOK_TIMER(serialiseHistogram);
+        std::string tempFilename = snapshotFilename + ".tmp";
+        std::ofstream outFile(tempFilename, std::ios::binary | std::ios::trunc);
+        if (!outFile.is_open()) {
+            return;
+        }
+
+        // Gather both sides into one contiguous buffer for a single write
+        std::vector<SnapshotRecord> records;
+        for (const auto& askLevel : orderBookData.getAskLadder()) {
+            for (OrderHandle handle : askLevel.second) {
+                const Order& ask = orderBookData.getOrder(handle);
+                records.push_back(SnapshotRecord{'A', ask.getPrice(), ask.getQuantity(), ask.getOrderID()});
+            }
+        }
+        for (const auto& bidLevel : orderBookData.getBidLadder()) {
+            for (OrderHandle handle : bidLevel.second) {
+                const Order& bid = orderBookData.getOrder(handle);
+                records.push_back(SnapshotRecord{'B', bid.getPrice(), bid.getQuantity(), bid.getOrderID()});
+            }
+        }
+
+        SnapshotHeader header;
+        header.magic = snapshotMagic;
+        header.version = snapshotVersion;
+        header.orderCount = records.size();
+        outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!records.empty()) {
+            outFile.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(SnapshotRecord));
+        }
+        outFile.close();
+
+        // Force the new snapshot to disk before atomically replacing the old
+        // one; readers only ever see a complete snapshot
+        int fd = open(tempFilename.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fsync(fd);
+            close(fd);
+        }
+        std::rename(tempFilename.c_str(), snapshotFilename.c_str());
+    }
+
+    // Writes the book as CSV for interchange with external tooling, one
+    // `side,price,quantity,orderID` line per resting order. Loadable again
+    // with importCSV.
+    void exportCSV(const OrderBookData& orderBookData, const std::string& path) {
+        std::ofstream outFile(path);
+        if (!outFile.is_open()) {
+            return;
+        }
+        std::vector<char> output;
+        output.reserve(1 << 20);
+        char record[64];
+
+        auto appendOrder = [&](const Order& order) {
+            char* cursor = record;
+            *cursor++ = (order.getSide() == Side::ASK) ? 'A' : 'B';
+            *cursor++ = ',';
+            cursor = std::to_chars(cursor, record + sizeof(record), order.getPrice()).ptr;
+            *cursor++ = ',';
+            cursor = std::to_chars(cursor, record + sizeof(record), order.getQuantity()).ptr;
+            *cursor++ = ',';
+            cursor = std::to_chars(cursor, record + sizeof(record), order.getOrderID()).ptr;
+            *cursor++ = '\n';
+            output.insert(output.end(), record, cursor);
+        };
+
+        for (const auto& askLevel : orderBookData.getAskLadder()) {
+            for (OrderHandle handle : askLevel.second) {
+                appendOrder(orderBookData.getOrder(handle));
+            }
+        }
+        for (const auto& bidLevel : orderBookData.getBidLadder()) {
+            for (OrderHandle handle : bidLevel.second) {
+                appendOrder(orderBookData.getOrder(handle));
+            }
+        }
+        outFile.write(output.data(), output.size());
+    }
+
+    // Bulk-loads a CSV interchange file straight into the book. The mapped
+    // buffer is scanned for record delimiters sixteen bytes at a time
+    // (SSE2, with a scalar fallback) and fields are parsed in place with a
+    // branch-light integer kernel — no per-record string temporaries, and
+    // orders are constructed straight into the pool allocator. Lines that
+    // are blank or start with '#' are skipped. Returns the number of orders
+    // loaded, or -1 if the file cannot be read.
+    long importCSV(OrderBookData& orderBookData, const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return -1;
+        }
+        struct stat fileInfo;
+        if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size == 0) {
+            close(fd);
+            return fileInfo.st_size == 0 ? 0 : -1;
+        }
+        void* mapped = mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            return -1;
+        }
+
+        const char* cursor = static_cast<const char*>(mapped);
+        const char* end = cursor + fileInfo.st_size;
+        long loaded = 0;
+        while (cursor < end) {
+            const char* lineEnd = findNewline(cursor, end);
+            if (cursor < lineEnd && *cursor != '#') {
+                char side = *cursor;
+                cursor += 2;  // Side character and its comma
+                int price = parseInt(cursor, lineEnd);
+                cursor++;
+                int quantity = parseInt(cursor, lineEnd);
+                cursor++;
+                int orderID = parseInt(cursor, lineEnd);
+                if (side == 'A') {
+                    orderBookData.addAskOrder(Order(Side::ASK, price, quantity, orderID));
+                } else {
+                    orderBookData.addBidOrder(Order(Side::BID, price, quantity, orderID));
+                }
+                // Keep the sequencer floor above every loaded ID, exactly as
+                // the snapshot, delta and event-log loaders do, so orders
+                // placed after an import can never collide with imported ones
+                noteOrderID(orderID);
+                loaded++;
+            }
+            cursor = lineEnd + 1;
+        }
+        munmap(mapped, fileInfo.st_size);
+        return loaded;
+    }
+
+    // Optional JSON export for tooling; no longer on the persistence path
+    void exportJSON(const OrderBookData& orderBookData) {
+        std::ofstream outFile(filename);
+        if (!outFile.is_open()) {
+            return;
+        }
+
+        // Format every order into one preallocated buffer and write it in a
+        // single pass — no per-order string temporaries
+        std::vector<char> output;
+        output.reserve(1 << 20);
+        char record[96];
+        bool flag = false;
+
+        auto appendOrder = [&](const Order& order) {
+            if (flag) {
+                output.push_back(',');
+                output.push_back('\n');
+            }
+            size_t length = order.writeJSON(record, sizeof(record));
+            output.insert(output.end(), record, record + length);
+            flag = true;
+        };
+
+        // Walk the ladders level by level, preserving time priority within each level
+        for (const auto& askLevel : orderBookData.getAskLadder()) {
+            for (OrderHandle handle : askLevel.second) {
+                appendOrder(orderBookData.getOrder(handle));
+            }
+        }
+        for (const auto& bidLevel : orderBookData.getBidLadder()) {
+            for (OrderHandle handle : bidLevel.second) {
+                appendOrder(orderBookData.getOrder(handle));
+            }
+        }
+
+        outFile << "[\n";
+        outFile.write(output.data(), output.size());
+        outFile << "\n]" << std::endl;
+    }
+
+    // Loads the binary snapshot by memory-mapping it and bulk-inserting the
+    // fixed-width records straight into the book — no text parsing and no
+    // per-order temporaries. The delta log is applied on top of the base,
+    // then the event-log tail. The dirty journal is cleared after the delta
+    // but not after the replay: replayed events are still only in the event
+    // log, so the next incremental snapshot must capture them.
+    void deserialise(OrderBookData& orderBookData) {
+        if (!persistenceEnabled) {
+            return;
+        }
+        loadSnapshot(orderBookData);
+        applyDeltaLog(orderBookData);
+        orderBookData.clearDirtyOrders();
+        replayEventLog(orderBookData);
+    }
+
+    // Lower values bound recovery time more tightly; see snapshotInterval
+    void setSnapshotInterval(int interval) {
+        this->snapshotInterval = interval;
+    }
+
+    // Reserves a block of `count` order IDs and returns the first. The end
+    // of the block is persisted before any ID from it is handed out, so a
+    // crash can waste the tail of a block but never lets a restarted
+    // process reuse an ID already given to an order. With persistence off
+    // the sequencer is memory-only.
+    uint64_t reserveOrderIDBlock(uint64_t count) {
+        if (!sequencerLoaded) {
+            loadSequencer();
+        }
+        uint64_t first = idReservedThrough + 1;
+        idReservedThrough += count;
+        persistSequencer();
+        return first;
+    }
+
+    // Epoch of this process's sequencer, bumped once per start; lets
+    // downstream consumers tell replayed flow from live flow
+    uint32_t getOrderIDEpoch() {
+        if (!sequencerLoaded) {
+            loadSequencer();
+        }
+        return idEpoch;
+    }
+
+private:
+    // Raises the reservation floor past an order ID observed during
+    // recovery, covering books persisted before the sequencer file existed
+    void noteOrderID(int orderID) {
+        if (orderID > 0 && static_cast<uint64_t>(orderID) > idReservedThrough) {
+            idReservedThrough = orderID;
+        }
+    }
+
+    // Reads the persisted sequencer state (once, on first use) and starts a
+    // new epoch for this process
+    void loadSequencer() {
+        sequencerLoaded = true;
+        if (!persistenceEnabled) {
+            idEpoch++;
+            return;
+        }
+        std::ifstream inFile(sequencerFilename, std::ios::binary);
+        SequencerRecord record;
+        if (inFile.is_open() && inFile.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            if (record.reservedThrough > idReservedThrough) {
+                idReservedThrough = record.reservedThrough;
+            }
+            idEpoch = record.epoch;
+        }
+        idEpoch++;
+        persistSequencer();
+    }
+
+    // Rewrites the sequencer file atomically, same tmp/fsync/rename dance
+    // as the snapshot; 16 bytes every block reservation, not every order
+    void persistSequencer() {
+        if (!persistenceEnabled) {
+            return;
+        }
+        std::string tempFilename = sequencerFilename + ".tmp";
+        std::ofstream outFile(tempFilename, std::ios::binary | std::ios::trunc);
+        if (!outFile.is_open()) {
+            return;
+        }
+        SequencerRecord record{idReservedThrough, idEpoch, 0};
+        outFile.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        outFile.close();
+        int fd = open(tempFilename.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fsync(fd);
+            close(fd);
+        }
+        std::rename(tempFilename.c_str(), sequencerFilename.c_str());
+    }
+
+    // Returns the first '\n' in [p, end), or end. Compares sixteen bytes
+    // per step where SSE2 is available; the scalar tail handles the rest.
+    static const char* findNewline(const char* p, const char* end) {
+#if defined(__SSE2__)
+        const __m128i newline = _mm_set1_epi8('\n');
+        while (p + 16 <= end) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+            if (mask != 0) {
+                return p + __builtin_ctz(mask);
+            }
+            p += 16;
+        }
+#endif
+        while (p < end && *p != '\n') {
+            p++;
+        }
+        return p;
+    }
+
+    // Parses a decimal integer in place, advancing the cursor past its
+    // digits. The single range check per digit doubles as the terminator
+    // test, so the loop carries no separate delimiter branch.
+    static int parseInt(const char*& p, const char* end) {
+        bool negative = (p < end && *p == '-');
+        p += negative ? 1 : 0;
+        int value = 0;
+        while (p < end) {
+            unsigned digit = static_cast<unsigned>(*p) - '0';
+            if (digit > 9) {
+                break;
+            }
+            value = value * 10 + static_cast<int>(digit);
+            p++;
+        }
+        return negative ? -value : value;
+    }
+
+    // Appends one record per dirty order to the delta log; cost is
+    // proportional to the churn since the last serialise
+    void serialiseIncremental(const OrderBookData::DirtyMap& dirty) {
+        ORDERBOOK_TIMER(serialiseHistogram);
+        if (dirty.empty()) {
+            return;
+        }
+        std::vector<DeltaRecord> records;
+        records.reserve(dirty.size());
+        for (const auto& entry : dirty) {
+            const OrderBookData::DirtyRecord& order = entry.second;
+            char op = (order.op == 'R') ? 'R' : 'U';
+            records.push_back(DeltaRecord{op, SnapshotRecord{order.side, order.price, order.quantity, entry.first}});
+        }
+        deltaLog.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(DeltaRecord));
+        deltaLog.flush();
+        deltaRecordsWritten += records.size();
+    }
+
+    // Applies the delta log on top of the loaded base snapshot. An upsert of
+    // an ID already in the book replaces it; a removal of an unknown ID is a
+    // no-op (the order was added and removed between two full serialises).
+    void applyDeltaLog(OrderBookData& orderBookData) {
+        std::ifstream inFile(deltaFilename, std::ios::binary);
+        if (!inFile.is_open()) {
+            return;
+        }
+        DeltaRecord record;
+        long applied = 0;
+        while (inFile.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            noteOrderID(record.record.orderID);
+            Order removed;
+            orderBookData.removeOrder(record.record.orderID, removed);
+            if (record.op == 'U') {
+                if (record.record.side == 'A') {
+                    orderBookData.addAskOrder(Order(Side::ASK, record.record.price, record.record.quantity, record.record.orderID));
+                } else {
+                    orderBookData.addBidOrder(Order(Side::BID, record.record.price, record.record.quantity, record.record.orderID));
+                }
+            }
+            applied++;
+        }
+        deltaRecordsWritten = applied;
+        if (applied > 0) {
+            std::cout << "Applied " << applied << " delta records from " << deltaFilename << std::endl;
+        }
+    }
+
+    void loadSnapshot(OrderBookData& orderBookData) {
+        int fd = open(snapshotFilename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;  // First run: no snapshot yet
+        }
+
+        struct stat fileInfo;
+        if (fstat(fd, &fileInfo) != 0 || static_cast<size_t>(fileInfo.st_size) < sizeof(SnapshotHeader)) {
+            close(fd);
+            return;
+        }
+
+        void* mapped = mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Unable to map snapshot file: " << snapshotFilename << std::endl;
+            return;
+        }
+
+        const SnapshotHeader* header = static_cast<const SnapshotHeader*>(mapped);
+        size_t available = (fileInfo.st_size - sizeof(SnapshotHeader)) / sizeof(SnapshotRecord);
+        if (header->magic != snapshotMagic || header->version != snapshotVersion || header->orderCount > available) {
+            std::cerr << "Unrecognised snapshot file: " << snapshotFilename << std::endl;
+            munmap(mapped, fileInfo.st_size);
+            return;
+        }
+
+        const SnapshotRecord* records = reinterpret_cast<const SnapshotRecord*>(header + 1);
+        for (uint64_t i = 0; i < header->orderCount; i++) {
+            const SnapshotRecord& record = records[i];
+            noteOrderID(record.orderID);
+            if (record.side == 'A') {
+                orderBookData.addAskOrder(Order(Side::ASK, record.price, record.quantity, record.orderID));
+            } else {
+                orderBookData.addBidOrder(Order(Side::BID, record.price, record.quantity, record.orderID));
+            }
+        }
+        uint64_t loadedCount = header->orderCount;
+        munmap(mapped, fileInfo.st_size);
+        std::cout << "Loaded " << loadedCount << " orders from " << snapshotFilename << std::endl;
+    }
+
+    // Replays the post-snapshot event-log tail, so a crash between
+    // snapshots loses nothing and recovery work is bounded by the snapshot
+    // cadence. A clean shutdown leaves the log empty.
+    void replayEventLog(OrderBookData& orderBookData) {
+        std::ifstream inFile(eventLogFilename, std::ios::binary);
+        if (!inFile.is_open()) {
+            return;
+        }
+
+        EventRecord record;
+        long replayed = 0;
+        while (inFile.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            noteOrderID(record.orderID);
+            switch (record.eventType) {
+                case EVENT_ORDER_ADD:
+                    if (record.side == 'A') {
+                        orderBookData.addAskOrder(Order(Side::ASK, record.price, record.quantity, record.orderID));
+                    } else {
+                        orderBookData.addBidOrder(Order(Side::BID, record.price, record.quantity, record.orderID));
+                    }
+                    break;
+                case EVENT_CANCEL: {
+                    Order removed;
+                    orderBookData.removeOrder(record.orderID, removed);
+                    break;
+                }
+                case EVENT_TRADE: {
+                    // Reduce the resting order by the traded quantity. A
+                    // partial fill re-queues at the back of its level, which
+                    // is a small priority skew we accept during recovery.
+                    Order removed;
+                    if (orderBookData.removeOrder(record.orderID, removed) && removed.getQuantity() > record.quantity) {
+                        removed.setQuantity(removed.getQuantity() - record.quantity);
+                        if (removed.getSide() == Side::ASK) {
+                            orderBookData.addAskOrder(removed);
+                        } else {
+                            orderBookData.addBidOrder(removed);
+                        }
+                    }
+                    break;
+                }
+            }
+            replayed++;
+        }
+        if (replayed > 0) {
+            std::cout << "Replayed " << replayed << " events from " << eventLogFilename << std::endl;
+        }
+    }
+};
+
+inline SerialisationService *SerialisationService::uniqueInstance = nullptr;
+inline std::mutex SerialisationService::mtx;
+
+// How long an order may live in the book. GTC orders rest until cancelled;
+// IOC fills what it can immediately and discards the remainder; FOK fills
+// completely and immediately or not at all. IOC and FOK never rest.
+enum class TimeInForce : uint8_t {
+    GTC,
+    IOC,
+    FOK
+};
+
+// A single order submission, used by the batch entry API
+struct OrderRequest {
+    Side side;      // Side the order goes to
+    int price;      // Limit price of the order
+    int quantity;   // Quantity of the order
+};
+
+// Handles all operations related to the orderbook
+class OrderBook {
+private:
+    SerialisationService *serliaiser;
+    OrderBookData orderBookData;
+    ExecutionReportStream executionStream;
+
+    // IDs are handed out from blocks reserved through the serialiser, whose
+    // persisted high-water mark makes them restart-safe; see
+    // reserveOrderIDBlock. The hot path is a plain increment.
+    static const int idBlockSize = 4096;
+    int orderID = 0;     // Last ID handed out
+    int idBlockEnd = 0;  // Last ID in the currently reserved block
+
+    int nextOrderID() {
+        if (orderID >= idBlockEnd) {
+            uint64_t first = serliaiser->reserveOrderIDBlock(idBlockSize);
+            orderID = static_cast<int>(first) - 1;
+            idBlockEnd = static_cast<int>(first) + idBlockSize - 1;
+        }
+        return ++orderID;
+    }
+
+    // Capacity policy, all off by default; see setSideCapacity/setPriceBand
+    size_t maxOrdersPerSide = 0;
+    int maxTicksFromTouch = 0;
+
+    // While true, orders accumulate and continuous matching is suspended;
+    // see beginAuction/endAuction
+    bool auctionMode = false;
+
+    // Inserts one order and logs it, without matching or snapshotting, so
+    // batch entry can amortise those costs over the whole batch. Returns 0
+    // if the capacity policy rejected the order.
+    int insertOrder(Side side, int price, int quantity) {
+        ORDERBOOK_TIMER(insertHistogram);
+        // Orders beyond the price band never enter the book: far-from-touch
+        // flow is what inflates the ladder for weeks at a time
+        if (maxTicksFromTouch > 0) {
+            const OrderBookData::TopOfBook& top = orderBookData.getTopOfBook();
+            if (side == Side::BID && top.bidPrice != 0 && top.bidPrice - price > maxTicksFromTouch) {
+                return 0;
+            }
+            if (side == Side::ASK && top.askPrice != 0 && price - top.askPrice > maxTicksFromTouch) {
+                return 0;
+            }
+        }
+        // At capacity, the lowest-priority resting order makes room — unless
+        // the incoming order would itself be the lowest priority
+        if (maxOrdersPerSide > 0 && orderBookData.sideOrderCount(side) >= maxOrdersPerSide) {
+            int worstPrice = orderBookData.worstPrice(side);
+            bool incomingWorse = (side == Side::BID) ? (price <= worstPrice) : (price >= worstPrice);
+            if (incomingWorse) {
+                return 0;
+            }
+            cancel(orderBookData.worstOrderID(side));
+        }
+        Order order(side, price, quantity, nextOrderID());
+        if (side == Side::ASK) {
+            orderBookData.addAskOrder(order);
+            serliaiser->logEvent(SerialisationService::EVENT_ORDER_ADD, 'A', price, quantity, order.getOrderID());
+        } else {
+            orderBookData.addBidOrder(order);
+            serliaiser->logEvent(SerialisationService::EVENT_ORDER_ADD, 'B', price, quantity, order.getOrderID());
+        }
+        return order.getOrderID();
+    }
+
+public:
+    OrderBook() {
+        this->serliaiser = SerialisationService::getInstance();
+        serliaiser->deserialise(orderBookData);
+    }
+
+    // Books owned by a multi-book shard persist through their own stream
+    // instead of the global singleton
+    explicit OrderBook(SerialisationService *serliaiser) {
+        this->serliaiser = serliaiser;
+        this->serliaiser->deserialise(orderBookData);
+    }
+
+    // Snapshot on shutdown so the event log can be discarded
+    ~OrderBook() {
+        serliaiser->snapshot(orderBookData);
+    }
+
+    // Method to place an ask; returns the assigned order ID
+    int placeAsk(int price, int quantity) {
+        int placedID = insertOrder(Side::ASK, price, quantity);
+        serliaiser->maybeSnapshot(orderBookData);
+        return placedID;
+    }
+
+    // Method to place a bid; returns the assigned order ID
+    int placeBid(int price, int quantity) {
+        int placedID = insertOrder(Side::BID, price, quantity);
+        serliaiser->maybeSnapshot(orderBookData);
+        return placedID;
+    }
+
+    // Places a limit order with a time-in-force. GTC inserts and rests as
+    // placeAsk/placeBid do. IOC and FOK execute against the opposite side in
+    // the placement path itself and never touch the resting-book structures:
+    // if nothing (or, for FOK, not everything) crosses, the order is dropped
+    // without an insert, a log record or a snapshot check. Returns the
+    // quantity filled; for GTC the full quantity rests so this is always 0.
+    int placeOrder(Side side, int price, int quantity, TimeInForce timeInForce) {
+        if (timeInForce == TimeInForce::GTC) {
+            insertOrder(side, price, quantity);
+            serliaiser->maybeSnapshot(orderBookData);
+            return 0;
+        }
+        if (timeInForce == TimeInForce::FOK
+                && orderBookData.availableQuantity(side, price) < quantity) {
+            return 0;  // Killed: cannot fill completely, book untouched
+        }
+        // The aggressor only gets an ID once a fill is certain, so an IOC
+        // that crosses nothing never consumes a persisted sequencer ID
+        int aggressorID = 0;
+        int filled = orderBookData.executeImmediate(side, price, quantity,
+                [this, side, &aggressorID](const Order& resting, int matchedQuantity) {
+            if (aggressorID == 0) {
+                aggressorID = nextOrderID();
+            }
+            if (side == Side::BID) {
+                executionStream.publish(resting.getOrderID(), aggressorID, resting.getPrice(), matchedQuantity);
+                // Only the resting side is logged: the aggressor never
+                // existed in the book, so replay has nothing to reduce
+                serliaiser->logEvent(SerialisationService::EVENT_TRADE, 'A', resting.getPrice(), matchedQuantity, resting.getOrderID());
+            } else {
+                executionStream.publish(aggressorID, resting.getOrderID(), resting.getPrice(), matchedQuantity);
+                serliaiser->logEvent(SerialisationService::EVENT_TRADE, 'B', resting.getPrice(), matchedQuantity, resting.getOrderID());
+            }
+        });
+        if (filled > 0) {
+            serliaiser->maybeSnapshot(orderBookData);
+        }
+        return filled;
+    }
+
+    // Method to place a whole batch of orders, matching once at the end
+    // instead of per order, for replaying bursts such as opening auctions
+    void placeOrders(const std::vector<OrderRequest>& requests) {
+        for (const OrderRequest& request : requests) {
+            insertOrder(request.side, request.price, request.quantity);
+        }
+        matchBidAsk();
+    }
+
+    // Method to cancel a resting order by its ID
+    bool cancel(int cancelOrderID) {
+        Order removedOrder;
+        if (!orderBookData.removeOrder(cancelOrderID, removedOrder)) {
+            std::cout << "Order ID " << cancelOrderID << " not found" << std::endl;
+            return false;
+        }
+        char side = (removedOrder.getSide() == Side::ASK) ? 'A' : 'B';
+        serliaiser->logEvent(SerialisationService::EVENT_CANCEL, side, removedOrder.getPrice(), removedOrder.getQuantity(), cancelOrderID);
+        serliaiser->maybeSnapshot(orderBookData);
+        return true;
+    }
+
+    // Method to amend the price/quantity of a resting order. The order keeps
+    // its ID but is re-queued at the back of its (possibly new) price level.
+    bool modify(int modifyOrderID, int newPrice, int newQuantity) {
+        Order removedOrder;
+        if (!orderBookData.removeOrder(modifyOrderID, removedOrder)) {
+            std::cout << "Order ID " << modifyOrderID << " not found" << std::endl;
+            return false;
+        }
+        Order replacement(removedOrder.getSide(), newPrice, newQuantity, modifyOrderID);
+        char side;
+        if (removedOrder.getSide() == Side::ASK) {
+            orderBookData.addAskOrder(replacement);
+            side = 'A';
+        } else {
+            orderBookData.addBidOrder(replacement);
+            side = 'B';
+        }
+        serliaiser->logEvent(SerialisationService::EVENT_CANCEL, side, removedOrder.getPrice(), removedOrder.getQuantity(), modifyOrderID);
+        serliaiser->logEvent(SerialisationService::EVENT_ORDER_ADD, side, newPrice, newQuantity, modifyOrderID);
+        serliaiser->maybeSnapshot(orderBookData);
+        return true;
+    }
+
+    // Outcome of an auction uncross; price is 0 when nothing crossed
+    struct AuctionResult {
+        int uncrossingPrice;
+        long matchedVolume;
+    };
+
+    // Enters auction mode: orders accumulate without continuous matching
+    // (matchBidAsk becomes a no-op) until endAuction uncrosses the book
+    void beginAuction() {
+        auctionMode = true;
+    }
+
+    // Leaves auction mode and uncrosses the book: computes the single
+    // volume-maximising price in one merged pass over the aggregated
+    // crossing levels of both sides, then executes all crossing volume at
+    // that price in bulk. Ties on volume are broken by the smaller
+    // supply/demand imbalance, then by the lowest price.
+    AuctionResult endAuction() {
+        auctionMode = false;
+        const OrderBookData::AskLadder& asks = orderBookData.getAskLadder();
+        const OrderBookData::BidLadder& bids = orderBookData.getBidLadder();
+        if (asks.empty() || bids.empty() || bids.begin()->first < asks.begin()->first) {
+            return AuctionResult{0, 0};
+        }
+        int bestAsk = asks.begin()->first;
+        int bestBid = bids.begin()->first;
+
+        // Cumulative sell supply per crossing ask level, ascending price
+        std::vector<std::pair<int, long>> askCum;
+        long running = 0;
+        for (const auto& level : asks) {
+            if (level.first > bestBid) {
+                break;
+            }
+            for (OrderHandle handle : level.second) {
+                running += orderBookData.getOrder(handle).getQuantity();
+            }
+            askCum.push_back({level.first, running});
+        }
+        // Cumulative buy demand at or above each crossing bid level, stored
+        // ascending so both sides merge front to back
+        std::vector<std::pair<int, long>> bidCum;
+        running = 0;
+        for (const auto& level : bids) {
+            if (level.first < bestAsk) {
+                break;
+            }
+            for (OrderHandle handle : level.second) {
+                running += orderBookData.getOrder(handle).getQuantity();
+            }
+            bidCum.push_back({level.first, running});
+        }
+        std::reverse(bidCum.begin(), bidCum.end());
+
+        // Merge the candidate prices of both sides, tracking executable
+        // volume min(supply, demand) at each; pointers only move forward
+        int uncrossingPrice = 0;
+        long bestVolume = 0;
+        long bestImbalance = 0;
+        size_t candidateA = 0, candidateB = 0;  // Merge cursors
+        size_t supplyIdx = 0;                   // Ask levels priced <= candidate
+        size_t demandIdx = 0;                   // First bid level priced >= candidate
+        while (candidateA < askCum.size() || candidateB < bidCum.size()) {
+            int price;
+            if (candidateA < askCum.size() && candidateB < bidCum.size()) {
+                price = std::min(askCum[candidateA].first, bidCum[candidateB].first);
+            } else if (candidateA < askCum.size()) {
+                price = askCum[candidateA].first;
+            } else {
+                price = bidCum[candidateB].first;
+            }
+            while (candidateA < askCum.size() && askCum[candidateA].first == price) {
+                candidateA++;
+            }
+            while (candidateB < bidCum.size() && bidCum[candidateB].first == price) {
+                candidateB++;
+            }
+            while (supplyIdx < askCum.size() && askCum[supplyIdx].first <= price) {
+                supplyIdx++;
+            }
+            while (demandIdx < bidCum.size() && bidCum[demandIdx].first < price) {
+                demandIdx++;
+            }
+            long supply = (supplyIdx > 0) ? askCum[supplyIdx - 1].second : 0;
+            long demand = (demandIdx < bidCum.size()) ? bidCum[demandIdx].second : 0;
+            long volume = std::min(supply, demand);
+            long imbalance = std::abs(demand - supply);
+            if (volume > bestVolume || (volume == bestVolume && volume > 0 && imbalance < bestImbalance)) {
+                uncrossingPrice = price;
+                bestVolume = volume;
+                bestImbalance = imbalance;
+            }
+        }
+        if (bestVolume == 0) {
+            return AuctionResult{0, 0};
+        }
+
+        // All crossing volume executes at the one uncrossing price; the
+        // sweep kernel pairs the orders in price-time priority
+        long matchedVolume = 0;
+        orderBookData.matchCrossing([this, uncrossingPrice, &matchedVolume](const Order& ask, const Order& bid, int matchedQuantity) {
+            matchedVolume += matchedQuantity;
+            executionStream.publish(ask.getOrderID(), bid.getOrderID(), uncrossingPrice, matchedQuantity);
+            serliaiser->logEvent(SerialisationService::EVENT_TRADE, 'A', ask.getPrice(), matchedQuantity, ask.getOrderID());
+            serliaiser->logEvent(SerialisationService::EVENT_TRADE, 'B', bid.getPrice(), matchedQuantity, bid.getOrderID());
+        });
+        serliaiser->maybeSnapshot(orderBookData);
+        return AuctionResult{uncrossingPrice, matchedVolume};
+    }
+
+    // Method to match bid and ask orders; suspended while an auction is
+    // accumulating
+    void matchBidAsk() {
+        if (auctionMode) {
+            return;
+        }
+        ORDERBOOK_TIMER(matchHistogram);
+        orderBookData.matchCrossing([this](const Order& ask, const Order& bid, int matchedQuantity) {
+            executionStream.publish(ask.getOrderID(), bid.getOrderID(), ask.getPrice(), matchedQuantity);
+            // One record per side so replay can reduce both resting orders
+            serliaiser->logEvent(SerialisationService::EVENT_TRADE, 'A', ask.getPrice(), matchedQuantity, ask.getOrderID());
+            serliaiser->logEvent(SerialisationService::EVENT_TRADE, 'B', bid.getPrice(), matchedQuantity, bid.getOrderID());
+        });
+        serliaiser->maybeSnapshot(orderBookData);
+    }
+
+    // Method for executing a market buy order. Drains crossing ask levels in
+    // place via the immediate-fill kernel: resting quantities are reduced
+    // through the pool, so only the partially-filled boundary order is ever
+    // written back and there are no pop/re-push cycles. Fills are published
+    // with order ID 0 standing in for the anonymous market aggressor.
+    void marketBuy(int quantity) {
+        orderBookData.executeImmediate(Side::BID, std::numeric_limits<int>::max(), quantity,
+                [this](const Order& resting, int matchedQuantity) {
+            executionStream.publish(resting.getOrderID(), 0, resting.getPrice(), matchedQuantity);
+            serliaiser->logEvent(SerialisationService::EVENT_TRADE, 'A', resting.getPrice(), matchedQuantity, resting.getOrderID());
+        });
+        serliaiser->maybeSnapshot(orderBookData);
+    }
+
+    // Method for executing a market sell order; see marketBuy
+    void marketSell(int quantity) {
+        orderBookData.executeImmediate(Side::ASK, std::numeric_limits<int>::min(), quantity,
+                [this](const Order& resting, int matchedQuantity) {
+            executionStream.publish(0, resting.getOrderID(), resting.getPrice(), matchedQuantity);
+            serliaiser->logEvent(SerialisationService::EVENT_TRADE, 'B', resting.getPrice(), matchedQuantity, resting.getOrderID());
+        });
+        serliaiser->maybeSnapshot(orderBookData);
+    }
+
+    // Execution reports produced by the match paths; consumers poll this
+    ExecutionReportStream& getExecutionStream() {
+        return executionStream;
+    }
+
+    // Book data access for market-data consumers (top-of-book, depth,
+    // change-callback registration)
+    // Caps resting orders per side; when full, an incoming order evicts the
+    // lowest-priority resting one (worst price, youngest there) or is
+    // rejected if it would itself be the lowest priority. 0 = unbounded.
+    void setSideCapacity(size_t maxOrders) {
+        this->maxOrdersPerSide = maxOrders;
+    }
+
+    // Rejects incoming orders farther than maxTicks from their side's
+    // touch; 0 = no band
+    void setPriceBand(int maxTicks) {
+        this->maxTicksFromTouch = maxTicks;
+    }
+
+    // Evicts resting orders with IDs at or below the threshold. IDs are
+    // assigned monotonically, so an ID threshold is an age threshold: a
+    // caller that wants to drop orders older than some duration records the
+    // newest ID it had seen at that time. Returns the number evicted.
+    int evictStaleOrders(int maxStaleOrderID) {
+        std::vector<int> staleIDs;
+        for (const auto& level : orderBookData.getAskLadder()) {
+            for (OrderHandle handle : level.second) {
+                if (orderBookData.getOrder(handle).getOrderID() <= maxStaleOrderID) {
+                    staleIDs.push_back(orderBookData.getOrder(handle).getOrderID());
+                }
+            }
+        }
+        for (const auto& level : orderBookData.getBidLadder()) {
+            for (OrderHandle handle : level.second) {
+                if (orderBookData.getOrder(handle).getOrderID() <= maxStaleOrderID) {
+                    staleIDs.push_back(orderBookData.getOrder(handle).getOrderID());
+                }
+            }
+        }
+        for (int staleID : staleIDs) {
+            cancel(staleID);
+        }
+        return static_cast<int>(staleIDs.size());
+    }
+
+    // Sequencer epoch of this process, for tagging outbound flow
+    uint32_t getOrderIDEpoch() {
+        return serliaiser->getOrderIDEpoch();
+    }
+
+    OrderBookData& getOrderBookData() {
+        return orderBookData;
+    }
+
+    // Method to display the current order book, built on the aggregated
+    // depth query so it never copies or mutates the book
+    void displayOrderBook(int levels = 10) {
+        std::vector<OrderBookData::DepthLevel> bids = orderBookData.getDepth(Side::BID, levels);
+        std::vector<OrderBookData::DepthLevel> asks = orderBookData.getDepth(Side::ASK, levels);
+
+        std::cout << "-----------------------------------------\n";
+        std::cout << "\tBid\t\t\tAsk\n";
+        std::cout << "-----------------------------------------\n";
+
+        for (size_t i = 0; i < bids.size() || i < asks.size(); i++) {
+            if (i < bids.size()) {
+                std::cout << "Price "<< "£" << bids[i].price << " " << "Size " << bids[i].totalQuantity
+                          << " (" << bids[i].orderCount << ")" << "\t";
+            } else {
+                std::cout << "\t\t";
+            }
+
+            if (i < asks.size()) {
+                std::cout << "Price "<< "£" << asks[i].price << " " << "Size " << asks[i].totalQuantity
+                          << " (" << asks[i].orderCount << ")" << "\n";
+            } else {
+                std::cout << "\n";
+            }
+        }
+    }
+};
+
+// Fixed-size command passed from the intake side to the matching thread
+struct OrderCommand {
+    enum Type : uint8_t {
+        PLACE = 0,
+        CANCEL = 1,
+        MODIFY = 2,
+        MARKET_BUY = 3,
+        MARKET_SELL = 4
+    };
+
+    Type type;      // What the matching thread should do
+    Side side;      // Side for PLACE commands
+    int price;      // Limit price (PLACE) or new price (MODIFY)
+    int quantity;   // Quantity to place, modify to, or trade
+    int orderID;    // Target order for CANCEL/MODIFY
+};
+
+// Applies a single command to a book; shared by the single-book matching
+// engine and the per-symbol shards
+inline void applyOrderCommand(OrderBook& orderBook, const OrderCommand& command) {
+    switch (command.type) {
+        case OrderCommand::PLACE:
+            if (command.side == Side::ASK) {
+                orderBook.placeAsk(command.price, command.quantity);
+            } else {
+                orderBook.placeBid(command.price, command.quantity);
+            }
+            break;
+        case OrderCommand::CANCEL:
+            orderBook.cancel(command.orderID);
+            break;
+        case OrderCommand::MODIFY:
+            orderBook.modify(command.orderID, command.price, command.quantity);
+            break;
+        case OrderCommand::MARKET_BUY:
+            orderBook.marketBuy(command.quantity);
+            break;
+        case OrderCommand::MARKET_SELL:
+            orderBook.marketSell(command.quantity);
+            break;
+    }
+}
+
+// Runs the matching loop on a dedicated (optionally pinned) thread that
+// drains the SPSC ring in batches, decoupling order intake from matching
+class MatchingEngine {
+private:
+    OrderBook orderBook;
+    SPSCQueue<OrderCommand> commandQueue;
+    MarketDataView marketDataView;
+    std::thread matchingThread;
+    std::atomic<bool> running;
+    std::mutex submitMutex;  // Guards the ring's producer side for submitShared
+
+    // Bumped every time the matching loop finds its ring empty; lets
+    // waitUntilIdle tell "ring drained" apart from "batch fully matched"
+    std::atomic<uint64_t> idleIterations{0};
+
+    // Matching thread body: drain whatever is in the ring, then match once
+    // for the whole batch and publish the market-data view for off-thread
+    // readers
+    void runLoop() {
+        OrderCommand command;
+        while (running.load(std::memory_order_acquire)) {
+            bool drainedAny = false;
+            while (commandQueue.tryPop(command)) {
+                applyOrderCommand(orderBook, command);
+                drainedAny = true;
+            }
+            if (drainedAny) {
+                orderBook.matchBidAsk();
+                marketDataView.publish(orderBook.getOrderBookData());
+            } else {
+                idleIterations.fetch_add(1, std::memory_order_release);
+                std::this_thread::yield();
+            }
+        }
+        // Drain anything submitted between the stop flag and shutdown
+        while (commandQueue.tryPop(command)) {
+            applyOrderCommand(orderBook, command);
+        }
+        orderBook.matchBidAsk();
+        marketDataView.publish(orderBook.getOrderBookData());
+    }
+
+public:
+    // Pass a non-negative core number to pin the matching thread (Linux only)
+    explicit MatchingEngine(int matchingCore = -1) : running(true) {
+        matchingThread = std::thread(&MatchingEngine::runLoop, this);
+#ifdef __linux__
+        if (matchingCore >= 0) {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET(matchingCore, &cpuSet);
+            pthread_setaffinity_np(matchingThread.native_handle(), sizeof(cpuSet), &cpuSet);
+        }
+#endif
+    }
+
+    ~MatchingEngine() {
+        running.store(false, std::memory_order_release);
+        matchingThread.join();
+    }
+
+    MatchingEngine(const MatchingEngine &) = delete;
+    MatchingEngine &operator=(const MatchingEngine &) = delete;
+
+    // Producer-side submit; spins if the ring is momentarily full. The ring
+    // is single-producer, so only one thread may ever call this directly.
+    void submit(const OrderCommand& command) {
+        while (!commandQueue.tryPush(command)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Multi-producer variant: serialises producers with a mutex so the
+    // network front end and the debug shell can share the ring. Anything
+    // latency-critical should be the sole producer and use submit().
+    void submitShared(const OrderCommand& command) {
+        std::lock_guard<std::mutex> lock(submitMutex);
+        submit(command);
+    }
+
+    // Blocks until the matching thread has drained AND matched everything
+    // submitted so far, used by slow consumers such as the interactive
+    // display. An empty ring alone is not enough: the loop pops the whole
+    // batch before matching it, so the book may still be mid-match when the
+    // last command leaves the ring. Waiting for one further idle iteration
+    // guarantees the batch's match and publish have completed.
+    void waitUntilIdle() {
+        while (!commandQueue.empty()) {
+            std::this_thread::yield();
+        }
+        uint64_t observed = idleIterations.load(std::memory_order_acquire);
+        while (idleIterations.load(std::memory_order_acquire) == observed) {
+            std::this_thread::yield();
+        }
+    }
+
+    OrderBook& getOrderBook() {
+        return orderBook;
+    }
+
+    // Lock-free read view for market-data and risk readers on other threads
+    const MarketDataView& getMarketDataView() const {
+        return marketDataView;
+    }
+};
+
+// Network order-entry front end: a TCP or Unix-domain listener that decodes
+// fixed-layout binary order messages straight into OrderCommand structs and
+// feeds the engine's ingestion ring — no string parsing and no allocation
+// per message. All sockets are serviced by one poll loop thread, so the
+// server is a single producer; it shares the ring with the debug shell via
+// submitShared. A peer that sends a malformed message is disconnected.
+class OrderEntryServer {
+public:
+    // One order-entry message on the wire: fixed little-endian layout that
+    // maps one-to-one onto OrderCommand, so decode is a 16-byte copy
+    struct WireMessage {
+        uint8_t type;       // OrderCommand::Type
+        uint8_t side;       // Side value; only read for PLACE
+        uint16_t reserved;  // Padding, must be zero
+        int32_t price;
+        int32_t quantity;
+        int32_t orderID;
+    };
+    static_assert(sizeof(WireMessage) == 16, "wire layout must not change size");
+
+private:
+    MatchingEngine& engine;
+    int listenFd;
+    std::thread serverThread;
+    std::atomic<bool> running;
+    std::string unixSocketPath;  // Unlinked on shutdown when non-empty
+
+    // Per-connection read state; messages split across reads carry over
+    struct Connection {
+        int fd;
+        size_t pending = 0;
+        char buffer[1 << 12];
+    };
+
+    void startThread() {
+        running.store(true);
+        serverThread = std::thread(&OrderEntryServer::serverLoop, this);
+    }
+
+    // Reads whatever is available and submits every complete message.
+    // Returns false when the peer has gone away or violated the protocol.
+    bool serviceConnection(Connection& connection) {
+        ssize_t bytes = read(connection.fd, connection.buffer + connection.pending,
+                             sizeof(connection.buffer) - connection.pending);
+        if (bytes <= 0) {
+            return false;
+        }
+        connection.pending += static_cast<size_t>(bytes);
+        size_t offset = 0;
+        while (connection.pending - offset >= sizeof(WireMessage)) {
+            WireMessage message;
+            std::memcpy(&message, connection.buffer + offset, sizeof(message));
+            offset += sizeof(WireMessage);
+            if (message.type > OrderCommand::MARKET_SELL || message.side > 1 || message.reserved != 0) {
+                return false;
+            }
+            // Wire prices and quantities are tick and unit counts on the
+            // book's grid; converting through the fixed-point types keeps
+            // the boundary explicit — a finer wire grid rescales here — and
+            // rejects values the book cannot accept before they reach the
+            // ring. Cancels carry neither, so only the fields a command
+            // actually uses are validated.
+            BookPrice price = BookPrice::fromTicks(message.price);
+            BookQuantity quantity = BookQuantity::fromUnits(message.quantity);
+            bool needsPrice = message.type == OrderCommand::PLACE
+                    || message.type == OrderCommand::MODIFY;
+            bool needsQuantity = needsPrice || message.type == OrderCommand::MARKET_BUY
+                    || message.type == OrderCommand::MARKET_SELL;
+            if ((needsPrice && price <= BookPrice()) || (needsQuantity && quantity <= BookQuantity())) {
+                return false;
+            }
+            OrderCommand command{};
+            command.type = static_cast<OrderCommand::Type>(message.type);
+            command.side = static_cast<Side>(message.side);
+            command.price = static_cast<int>(price.rawTicks());
+            command.quantity = static_cast<int>(quantity.rawUnits());
+            command.orderID = message.orderID;
+            engine.submitShared(command);
+        }
+        if (offset > 0) {
+            std::memmove(connection.buffer, connection.buffer + offset, connection.pending - offset);
+            connection.pending -= offset;
+        }
+        return true;
+    }
+
+    // One poll loop services the listener and every connection, waking at
+    // least every 100ms to notice shutdown
+    void serverLoop() {
+        std::vector<struct pollfd> pollSet;
+        std::vector<std::unique_ptr<Connection>> connections;
+        while (running.load(std::memory_order_acquire)) {
+            pollSet.clear();
+            pollSet.push_back({listenFd, POLLIN, 0});
+            for (const std::unique_ptr<Connection>& connection : connections) {
+                pollSet.push_back({connection->fd, POLLIN, 0});
+            }
+            int ready = poll(pollSet.data(), pollSet.size(), 100);
+            if (ready <= 0) {
+                continue;
+            }
+            if (pollSet[0].revents & POLLIN) {
+                int clientFd = accept(listenFd, nullptr, nullptr);
+                if (clientFd >= 0) {
+                    std::unique_ptr<Connection> connection(new Connection());
+                    connection->fd = clientFd;
+                    connections.push_back(std::move(connection));
+                }
+                // pollSet was built before the accept, so it has no entry
+                // for the new connection; rebuild it before servicing rather
+                // than indexing past its end below
+                continue;
+            }
+            for (size_t i = 0; i < connections.size();) {
+                short revents = pollSet[i + 1].revents;
+                if ((revents & (POLLIN | POLLHUP | POLLERR)) && !serviceConnection(*connections[i])) {
+                    close(connections[i]->fd);
+                    connections.erase(connections.begin() + i);
+                    // pollSet is rebuilt next iteration; stop matching
+                    // stale entries against shifted connections
+                    break;
+                }
+                i++;
+            }
+        }
+        for (const std::unique_ptr<Connection>& connection : connections) {
+            close(connection->fd);
+        }
+    }
+
+public:
+    // TCP listener on the given port, all interfaces
+    OrderEntryServer(MatchingEngine& engine, uint16_t port)
+        : engine(engine), listenFd(-1), running(false) {
+        listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listenFd < 0) {
+            std::cerr << "Unable to create order-entry socket" << std::endl;
+            return;
+        }
+        int reuse = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        struct sockaddr_in address {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = INADDR_ANY;
+        address.sin_port = htons(port);
+        if (bind(listenFd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0
+                || listen(listenFd, 64) != 0) {
+            std::cerr << "Unable to listen on port " << port << std::endl;
+            close(listenFd);
+            listenFd = -1;
+            return;
+        }
+        startThread();
+    }
+
+    // Unix-domain listener at the given path; an existing socket file there
+    // is replaced
+    OrderEntryServer(MatchingEngine& engine, const std::string& socketPath)
+        : engine(engine), listenFd(-1), running(false), unixSocketPath(socketPath) {
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0) {
+            std::cerr << "Unable to create order-entry socket" << std::endl;
+            return;
+        }
+        struct sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+        unlink(socketPath.c_str());
+        if (bind(listenFd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0
+                || listen(listenFd, 64) != 0) {
+            std::cerr << "Unable to listen on " << socketPath << std::endl;
+            close(listenFd);
+            listenFd = -1;
+            return;
+        }
+        startThread();
+    }
+
+    ~OrderEntryServer() {
+        running.store(false);
+        if (serverThread.joinable()) {
+            serverThread.join();
+        }
+        if (listenFd >= 0) {
+            close(listenFd);
+        }
+        if (!unixSocketPath.empty()) {
+            unlink(unixSocketPath.c_str());
+        }
+    }
+
+    OrderEntryServer(const OrderEntryServer &) = delete;
+    OrderEntryServer &operator=(const OrderEntryServer &) = delete;
+
+    bool isListening() const {
+        return listenFd >= 0;
+    }
+};
+
+// Multi-instrument engine: symbols are hashed to shards, each shard owns its
+// books and drains its own command ring on a dedicated worker thread, so
+// independent instruments match in parallel with no shared mutable state
+class MultiBookEngine {
+public:
+    // Maximum length of an instrument name, including the terminator
+    static const size_t maxSymbolLength = 16;
+
+    // A routed command: which instrument, and what to do to its book
+    struct SymbolCommand {
+        char symbol[maxSymbolLength];
+        OrderCommand command;
+    };
+
+private:
+    // Everything a shard touches is owned by its worker thread; the ring is
+    // the only point of contact with the router
+    struct Shard {
+        SPSCQueue<SymbolCommand> commandQueue;
+        // Declared before the books so each book is destroyed — and takes
+        // its shutdown snapshot — before the stream it persists through
+        std::vector<std::unique_ptr<SerialisationService> > serialisers;
+        std::unordered_map<std::string, std::unique_ptr<OrderBook> > books;
+        std::thread worker;
+
+        // Bumped when the worker finds its ring empty; see waitUntilIdle
+        std::atomic<uint64_t> idleIterations{0};
+    };
+
+    std::vector<std::unique_ptr<Shard> > shards;
+    std::atomic<bool> running;
+
+    // FNV-1a over the symbol name; stable so a symbol always lands on the
+    // same shard
+    size_t shardFor(const char* symbol) const {
+        uint64_t hash = 1469598103934665603ULL;
+        for (const char* c = symbol; *c != '\0'; c++) {
+            hash = (hash ^ static_cast<uint8_t>(*c)) * 1099511628211ULL;
+        }
+        return static_cast<size_t>(hash % shards.size());
+    }
+
+    // Looks up (or lazily creates) the shard-owned book for a symbol
+    OrderBook& bookFor(Shard& shard, const char* symbol) {
+        std::unique_ptr<OrderBook>& book = shard.books[symbol];
+        if (book == nullptr) {
+            shard.serialisers.emplace_back(SerialisationService::createNamed(symbol));
+            book.reset(new OrderBook(shard.serialisers.back().get()));
+        }
+        return *book;
+    }
+
+    // Worker body: drain the shard's ring, then match every book the batch
+    // touched, exactly like the single-book matching loop
+    void shardLoop(Shard& shard) {
+        SymbolCommand routed;
+        std::vector<OrderBook*> touched;
+        while (running.load(std::memory_order_acquire)) {
+            while (shard.commandQueue.tryPop(routed)) {
+                OrderBook& book = bookFor(shard, routed.symbol);
+                applyOrderCommand(book, routed.command);
+                if (std::find(touched.begin(), touched.end(), &book) == touched.end()) {
+                    touched.push_back(&book);
+                }
+            }
+            if (!touched.empty()) {
+                for (OrderBook* book : touched) {
+                    book->matchBidAsk();
+                }
+                touched.clear();
+            } else {
+                shard.idleIterations.fetch_add(1, std::memory_order_release);
+                std::this_thread::yield();
+            }
+        }
+        // Drain anything routed between the stop flag and shutdown
+        while (shard.commandQueue.tryPop(routed)) {
+            OrderBook& book = bookFor(shard, routed.symbol);
+            applyOrderCommand(book, routed.command);
+            book.matchBidAsk();
+        }
+    }
+
+public:
+    explicit MultiBookEngine(size_t shardCount) : running(true) {
+        if (shardCount == 0) {
+            shardCount = 1;
+        }
+        for (size_t i = 0; i < shardCount; i++) {
+            shards.push_back(std::unique_ptr<Shard>(new Shard()));
+        }
+        for (size_t i = 0; i < shardCount; i++) {
+            Shard* shard = shards[i].get();
+            shard->worker = std::thread(&MultiBookEngine::shardLoop, this, std::ref(*shard));
+        }
+    }
+
+    ~MultiBookEngine() {
+        running.store(false, std::memory_order_release);
+        for (std::unique_ptr<Shard>& shard : shards) {
+            if (shard->worker.joinable()) {
+                shard->worker.join();
+            }
+        }
+    }
+
+    MultiBookEngine(const MultiBookEngine &) = delete;
+    MultiBookEngine &operator=(const MultiBookEngine &) = delete;
+
+    // Routes a command to its symbol's shard; spins if that ring is full.
+    // Single router thread assumed, matching the SPSC ring's contract.
+    void submit(const std::string& symbol, const OrderCommand& command) {
+        SymbolCommand routed{};
+        std::strncpy(routed.symbol, symbol.c_str(), maxSymbolLength - 1);
+        routed.command = command;
+        Shard& shard = *shards[shardFor(routed.symbol)];
+        while (!shard.commandQueue.tryPush(routed)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Blocks until every shard has drained its ring and finished matching
+    // the batch it was on; an empty ring alone can still mean a match is in
+    // flight, exactly as in MatchingEngine::waitUntilIdle
+    void waitUntilIdle() {
+        for (std::unique_ptr<Shard>& shard : shards) {
+            while (!shard->commandQueue.empty()) {
+                std::this_thread::yield();
+            }
+            uint64_t observed = shard->idleIterations.load(std::memory_order_acquire);
+            while (shard->idleIterations.load(std::memory_order_acquire) == observed) {
+                std::this_thread::yield();
+            }
+        }
+    }
+};
+
+// Class to let the user interact with the program, layered on top of the
+// matching engine's command ring like any other intake source
+class UserInterface {
+private:
+    MatchingEngine engine;
+
+public:
+    UserInterface() = default;
+    ~UserInterface() = default;
+
+    // The engine is shared with the network order-entry front end, which
+    // rides the same command path as this debug shell
+    MatchingEngine& getEngine() {
+        return engine;
+    }
+
+    void display() {
+        // Let the matching thread catch up before reading the book
+        engine.waitUntilIdle();
+        // Pretty-print fills as the slow consumer of the execution stream
+        engine.getOrderBook().getExecutionStream().drainToConsole();
+        engine.getOrderBook().displayOrderBook();
+    }
+
+    void run() {
+        std::string input;
+        display();
+        while (true) {
+            std::cout << "\nOptions: [bid / ask / cancel / modify / exit]\nEnter command: ";
+            std::cin >> input;
+
+            OrderCommand command{};
+            if (input == "bid") {
+                std::cout << "Enter bid price: ";
+                std::cin >> command.price;
+                std::cout << "Enter bid quantity: ";
+                std::cin >> command.quantity;
+                command.type = OrderCommand::PLACE;
+                command.side = Side::BID;
+                engine.submitShared(command);
+                std::cout << "Bid submitted successfully.\n";
+            } else if (input == "ask") {
+                std::cout << "Enter ask price: ";
+                std::cin >> command.price;
+                std::cout << "Enter ask quantity: ";
+                std::cin >> command.quantity;
+                command.type = OrderCommand::PLACE;
+                command.side = Side::ASK;
+                engine.submitShared(command);
+                std::cout << "Ask submitted successfully.\n";
+            } else if (input == "cancel") {
+                std::cout << "Enter order ID: ";
+                std::cin >> command.orderID;
+                command.type = OrderCommand::CANCEL;
+                engine.submitShared(command);
+                std::cout << "Cancel submitted.\n";
+            } else if (input == "modify") {
+                std::cout << "Enter order ID: ";
+                std::cin >> command.orderID;
+                std::cout << "Enter new price: ";
+                std::cin >> command.price;
+                std::cout << "Enter new quantity: ";
+                std::cin >> command.quantity;
+                command.type = OrderCommand::MODIFY;
+                engine.submitShared(command);
+                std::cout << "Modify submitted.\n";
+            } else if (input == "exit") {
+                std::cout << "Exiting the program...\n";
+                break;
+            } else {
+                std::cout << "Invalid command. Please try again.\n";
+            }
+            display();
+        }
+    }
+};
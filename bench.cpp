@@ -0,0 +1,174 @@
+#include "OrderBook.hpp"
+
+#include <chrono>
+#include <random>
+#include <iomanip>
+
+// Benchmark harness for the matching engine: generates deterministic
+// synthetic order flow and reports throughput plus latency percentiles for
+// each operation, with and without persistence enabled.
+//
+// Usage: bench [numOrders] [cancelPercent] [marketPercent]
+
+// Per-operation latency samples, in nanoseconds
+struct LatencyStats {
+    std::vector<long> samples;
+
+    void record(long nanos) {
+        samples.push_back(nanos);
+    }
+
+    long percentile(double p) {
+        if (samples.empty()) {
+            return 0;
+        }
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        return samples[index];
+    }
+
+    void report(const std::string& name) {
+        if (samples.empty()) {
+            return;
+        }
+        std::sort(samples.begin(), samples.end());
+        long total = 0;
+        for (long sample : samples) {
+            total += sample;
+        }
+        std::cout << std::left << std::setw(14) << name
+                  << " n=" << std::setw(8) << samples.size()
+                  << " mean=" << std::setw(8) << (total / static_cast<long>(samples.size()))
+                  << " p50=" << std::setw(8) << percentile(0.50)
+                  << " p90=" << std::setw(8) << percentile(0.90)
+                  << " p99=" << std::setw(8) << percentile(0.99)
+                  << " p99.9=" << std::setw(8) << percentile(0.999)
+                  << " (ns)" << std::endl;
+    }
+};
+
+// Synthetic flow parameters; the fixed seed makes every run identical
+struct BenchConfig {
+    int numOrders = 100000;
+    int cancelPercent = 20;   // Percentage of operations that are cancels
+    int marketPercent = 10;   // Percentage of operations that are market orders
+    int midPrice = 100;
+    int priceRange = 20;      // Limit prices are drawn from mid +/- range
+    int maxQuantity = 100;
+    unsigned int seed = 42;
+};
+
+// Runs one full pass of synthetic flow through a fresh OrderBook
+void runBench(const BenchConfig& config, bool persist) {
+    SerialisationService::getInstance()->setPersistenceEnabled(persist);
+
+    OrderBook orderBook;
+    std::mt19937 rng(config.seed);
+    std::uniform_int_distribution<int> opDist(0, 99);
+    std::uniform_int_distribution<int> priceDist(config.midPrice - config.priceRange,
+                                                 config.midPrice + config.priceRange);
+    std::uniform_int_distribution<int> quantityDist(1, config.maxQuantity);
+    std::uniform_int_distribution<int> sideDist(0, 1);
+
+    LatencyStats placeBidStats, placeAskStats, cancelStats, matchStats, marketBuyStats, marketSellStats;
+
+    // Match logging still goes through std::cout; suppress it so the
+    // benchmark measures the engine, not the terminal
+    std::cout.setstate(std::ios::failbit);
+
+    // Cancel targets are drawn from the IDs actually assigned, which no
+    // longer start at 1: the sequencer hands out restart-safe blocks
+    int firstOrderID = 0;
+    int lastOrderID = 0;
+    auto runStart = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < config.numOrders; i++) {
+        int op = opDist(rng);
+        auto start = std::chrono::steady_clock::now();
+
+        if (op < config.cancelPercent && lastOrderID > firstOrderID) {
+            std::uniform_int_distribution<int> idDist(firstOrderID, lastOrderID);
+            orderBook.cancel(idDist(rng));
+            auto end = std::chrono::steady_clock::now();
+            cancelStats.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        } else if (op < config.cancelPercent + config.marketPercent) {
+            int quantity = quantityDist(rng);
+            if (sideDist(rng) == 0) {
+                orderBook.marketBuy(quantity);
+                auto end = std::chrono::steady_clock::now();
+                marketBuyStats.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            } else {
+                orderBook.marketSell(quantity);
+                auto end = std::chrono::steady_clock::now();
+                marketSellStats.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            }
+        } else {
+            int price = priceDist(rng);
+            int quantity = quantityDist(rng);
+            if (sideDist(rng) == 0) {
+                lastOrderID = orderBook.placeBid(price, quantity);
+                auto end = std::chrono::steady_clock::now();
+                placeBidStats.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            } else {
+                lastOrderID = orderBook.placeAsk(price, quantity);
+                auto end = std::chrono::steady_clock::now();
+                placeAskStats.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            }
+            if (firstOrderID == 0) {
+                firstOrderID = lastOrderID;
+            }
+        }
+
+        // Match periodically, the way the interactive loop and the matching
+        // thread both batch matching over recent inserts
+        if (i % 64 == 63) {
+            auto matchStart = std::chrono::steady_clock::now();
+            orderBook.matchBidAsk();
+            auto matchEnd = std::chrono::steady_clock::now();
+            matchStats.record(std::chrono::duration_cast<std::chrono::nanoseconds>(matchEnd - matchStart).count());
+        }
+    }
+
+    auto runEnd = std::chrono::steady_clock::now();
+    std::cout.clear();
+
+    double seconds = std::chrono::duration_cast<std::chrono::microseconds>(runEnd - runStart).count() / 1e6;
+    std::cout << "\n=== " << (persist ? "persistence ON" : "persistence OFF") << " ===" << std::endl;
+    std::cout << "Operations: " << config.numOrders << " in " << seconds << "s ("
+              << static_cast<long>(config.numOrders / seconds) << " ops/sec)" << std::endl;
+    placeBidStats.report("placeBid");
+    placeAskStats.report("placeAsk");
+    cancelStats.report("cancel");
+    matchStats.report("matchBidAsk");
+    marketBuyStats.report("marketBuy");
+    marketSellStats.report("marketSell");
+}
+
+int main(int argc, char *argv[]) {
+    BenchConfig config;
+    if (argc > 1) {
+        config.numOrders = std::stoi(argv[1]);
+    }
+    if (argc > 2) {
+        config.cancelPercent = std::stoi(argv[2]);
+    }
+    if (argc > 3) {
+        config.marketPercent = std::stoi(argv[3]);
+    }
+
+    // Run in a scratch directory so the persistence passes never touch a
+    // real book's snapshot or event log
+    char scratchDir[] = "/tmp/orderbook_bench_XXXXXX";
+    if (mkdtemp(scratchDir) != nullptr) {
+        if (chdir(scratchDir) != 0) {
+            std::cerr << "Unable to enter scratch directory " << scratchDir << std::endl;
+        }
+    }
+
+    std::cout << "OrderBook benchmark: " << config.numOrders << " ops, "
+              << config.cancelPercent << "% cancel, " << config.marketPercent
+              << "% market, seed " << config.seed << std::endl;
+
+    runBench(config, false);
+    runBench(config, true);
+    return 0;
+}
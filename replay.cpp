@@ -0,0 +1,255 @@
+#include "OrderBook.hpp"
+
+#include <chrono>
+#include <climits>
+
+// Replay driver: feeds a captured command stream through an OrderBook as
+// fast as possible (default) or paced at the original capture timestamps,
+// then optionally verifies the final book state against a reference
+// snapshot and reports sustained throughput. This is the capacity-planning
+// and soak harness for the engine, so it deliberately goes straight to
+// OrderBook rather than through the interactive shell.
+//
+// Usage: replay <capture file> [--paced] [--persist] [--verify <snapshot.bin>]
+//
+// Capture formats, picked by file extension:
+//   .bin  packed ReplayRecord structs, written as captured
+//   .csv  one command per line: timestampNanos,type,side,price,quantity,orderID
+//         type is place/cancel/modify/buy/sell/match; side is A or B and only
+//         read for place. Blank lines and lines starting with '#' are skipped.
+//
+// A `match` record marks where the capture ran the matching pass, so replay
+// reproduces the original matching cadence; one final pass always runs at
+// end of stream.
+
+// One captured command plus its offset from the start of the capture
+struct ReplayRecord {
+    uint64_t timestampNanos;  // Nanoseconds since the first captured command
+    OrderCommand command;
+};
+
+// Marks a matching pass in the capture; never handed to applyOrderCommand
+const uint8_t REPLAY_MATCH = 0xFF;
+
+// Parses one CSV capture line into a record; returns false on malformed input
+bool parseCSVRecord(const std::string& line, ReplayRecord& record) {
+    std::istringstream stream(line);
+    std::string timestampField, typeField, sideField, priceField, quantityField, orderIDField;
+    if (!std::getline(stream, timestampField, ',') || !std::getline(stream, typeField, ',')
+            || !std::getline(stream, sideField, ',') || !std::getline(stream, priceField, ',')
+            || !std::getline(stream, quantityField, ',') || !std::getline(stream, orderIDField)) {
+        return false;
+    }
+    record.timestampNanos = std::stoull(timestampField);
+    record.command.side = (sideField == "A") ? Side::ASK : Side::BID;
+    record.command.price = std::stoi(priceField);
+    record.command.quantity = std::stoi(quantityField);
+    record.command.orderID = std::stoi(orderIDField);
+    if (typeField == "place") {
+        record.command.type = OrderCommand::PLACE;
+    } else if (typeField == "cancel") {
+        record.command.type = OrderCommand::CANCEL;
+    } else if (typeField == "modify") {
+        record.command.type = OrderCommand::MODIFY;
+    } else if (typeField == "buy") {
+        record.command.type = OrderCommand::MARKET_BUY;
+    } else if (typeField == "sell") {
+        record.command.type = OrderCommand::MARKET_SELL;
+    } else if (typeField == "match") {
+        record.command.type = static_cast<OrderCommand::Type>(REPLAY_MATCH);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Loads the whole capture up front so the replay loop measures the engine,
+// not file parsing
+bool loadCapture(const std::string& path, std::vector<ReplayRecord>& records) {
+    bool binary = path.size() >= 4 && path.compare(path.size() - 4, 4, ".bin") == 0;
+    if (binary) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        ReplayRecord record;
+        while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            records.push_back(record);
+        }
+        return true;
+    }
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        ReplayRecord record;
+        if (!parseCSVRecord(line, record)) {
+            std::cerr << "Malformed capture line " << lineNumber << ": " << line << std::endl;
+            return false;
+        }
+        records.push_back(record);
+    }
+    return true;
+}
+
+// Flattens a book side into orderID -> (side, price, quantity) for comparison
+void collectOrders(const OrderBookData& data,
+                   std::map<int, SerialisationService::SnapshotRecord>& orders) {
+    for (const auto& level : data.getAskLadder()) {
+        for (OrderHandle handle : level.second) {
+            const Order& order = data.getOrder(handle);
+            orders[order.getOrderID()] = SerialisationService::SnapshotRecord{
+                'A', order.getPrice(), order.getQuantity(), order.getOrderID()};
+        }
+    }
+    for (const auto& level : data.getBidLadder()) {
+        for (OrderHandle handle : level.second) {
+            const Order& order = data.getOrder(handle);
+            orders[order.getOrderID()] = SerialisationService::SnapshotRecord{
+                'B', order.getPrice(), order.getQuantity(), order.getOrderID()};
+        }
+    }
+}
+
+// Compares the final book against a reference snapshot file (the same
+// format SerialisationService writes). Returns true when they agree.
+bool verifyAgainstSnapshot(OrderBook& orderBook, const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot open reference snapshot " << path << std::endl;
+        return false;
+    }
+    SerialisationService::SnapshotHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+            || header.magic != SerialisationService::snapshotMagic) {
+        std::cerr << "Not a valid snapshot: " << path << std::endl;
+        return false;
+    }
+
+    std::map<int, SerialisationService::SnapshotRecord> actual;
+    collectOrders(orderBook.getOrderBookData(), actual);
+
+    size_t mismatches = 0;
+    SerialisationService::SnapshotRecord expected;
+    for (uint64_t i = 0; i < header.orderCount; i++) {
+        if (!file.read(reinterpret_cast<char*>(&expected), sizeof(expected))) {
+            std::cerr << "Snapshot truncated at record " << i << std::endl;
+            return false;
+        }
+        std::map<int, SerialisationService::SnapshotRecord>::iterator it = actual.find(expected.orderID);
+        if (it == actual.end()) {
+            std::cerr << "Missing order ID " << expected.orderID << std::endl;
+            mismatches++;
+        } else if (it->second.side != expected.side || it->second.price != expected.price
+                   || it->second.quantity != expected.quantity) {
+            std::cerr << "Order ID " << expected.orderID << " differs: have "
+                      << it->second.side << " " << it->second.price << "x" << it->second.quantity
+                      << ", expected " << expected.side << " " << expected.price
+                      << "x" << expected.quantity << std::endl;
+            mismatches++;
+            actual.erase(it);
+        } else {
+            actual.erase(it);
+        }
+    }
+    for (const auto& extra : actual) {
+        std::cerr << "Unexpected order ID " << extra.first << " resting in book" << std::endl;
+        mismatches++;
+    }
+    return mismatches == 0;
+}
+
+int main(int argc, char *argv[]) {
+    std::string capturePath;
+    std::string referencePath;
+    bool paced = false;
+    bool persist = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--paced") {
+            paced = true;
+        } else if (arg == "--persist") {
+            persist = true;
+        } else if (arg == "--verify" && i + 1 < argc) {
+            referencePath = argv[++i];
+        } else if (capturePath.empty()) {
+            capturePath = arg;
+        }
+    }
+    if (capturePath.empty()) {
+        std::cerr << "Usage: replay <capture file> [--paced] [--persist] [--verify <snapshot.bin>]" << std::endl;
+        return 1;
+    }
+
+    std::vector<ReplayRecord> records;
+    if (!loadCapture(capturePath, records)) {
+        std::cerr << "Failed to load capture " << capturePath << std::endl;
+        return 1;
+    }
+    std::cout << "Loaded " << records.size() << " commands from " << capturePath << std::endl;
+
+    // The scratch chdir below would break a relative reference path, so pin
+    // it down first
+    if (!referencePath.empty()) {
+        char resolved[PATH_MAX];
+        if (realpath(referencePath.c_str(), resolved) != nullptr) {
+            referencePath = resolved;
+        }
+    }
+
+    // Replays run in a scratch directory so a persisting run never touches a
+    // real book's snapshot or event log; without --persist the stream is off.
+    // The chdir must come before the first getInstance() call, because the
+    // singleton opens its log streams in the current directory on
+    // construction and keeps appending to them from there.
+    char scratchDir[] = "/tmp/orderbook_replay_XXXXXX";
+    if (mkdtemp(scratchDir) != nullptr) {
+        if (chdir(scratchDir) != 0) {
+            std::cerr << "Unable to enter scratch directory " << scratchDir << std::endl;
+        }
+    }
+    SerialisationService::getInstance()->setPersistenceEnabled(persist);
+
+    OrderBook orderBook;
+
+    // Cancel/modify misses and match logging go through std::cout; suppress
+    // them so the replay measures the engine, not the terminal
+    std::cout.setstate(std::ios::failbit);
+
+    auto replayStart = std::chrono::steady_clock::now();
+    for (const ReplayRecord& record : records) {
+        if (paced) {
+            std::this_thread::sleep_until(replayStart + std::chrono::nanoseconds(record.timestampNanos));
+        }
+        if (static_cast<uint8_t>(record.command.type) == REPLAY_MATCH) {
+            orderBook.matchBidAsk();
+        } else {
+            applyOrderCommand(orderBook, record.command);
+        }
+    }
+    orderBook.matchBidAsk();
+    auto replayEnd = std::chrono::steady_clock::now();
+    std::cout.clear();
+
+    double seconds = std::chrono::duration_cast<std::chrono::microseconds>(replayEnd - replayStart).count() / 1e6;
+    std::cout << "Replayed " << records.size() << " commands in " << seconds << "s ("
+              << static_cast<long>(records.size() / seconds) << " commands/sec"
+              << (paced ? ", paced" : "") << ")" << std::endl;
+
+    if (!referencePath.empty()) {
+        if (verifyAgainstSnapshot(orderBook, referencePath)) {
+            std::cout << "Final book state matches " << referencePath << std::endl;
+        } else {
+            std::cout << "Final book state DIFFERS from " << referencePath << std::endl;
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,841 @@
+#include "OrderBook.hpp"
+
+#include <chrono>
+#include <random>
+#include <set>
+
+// Stress and soak harness: the acceptance gate for the concurrency work.
+// Every phase has hard pass/fail criteria:
+//
+//   - Concurrency soak, run with persistence off and then on — multi-threaded
+//     producers hammer the matching engine through the shared ring for a
+//     configurable duration while a checker thread continuously validates the
+//     published market-data view (the book must never appear crossed) and a
+//     consumer drains the execution stream. Afterwards quantity conservation
+//     and order-index consistency are verified against the final book.
+//
+//   - Semantics cross-check — a deterministic single-threaded command
+//     sequence is applied both to an OrderBook (matching after every
+//     command) and to a deliberately simple reference book built on plain
+//     maps and deques, then the final books are compared order by order.
+//
+//   - Directed phases covering the paths random flow cannot reach: the
+//     time-in-force placement path, CSV interchange round-trips, auction
+//     uncrossing against a reference computation, and the sharded
+//     multi-book engine verified through per-symbol persistence recovery.
+//
+// Usage: stress [soakSeconds] [producers] [cancelPercent] [crossCheckCommands]
+//
+// cancelPercent 0 tightens the soak's conservation check to exact
+// equality: with cancels in play the cancelled quantity can only be
+// derived, not independently observed, so it is checked for consistency
+// rather than equality. Run with a large soakSeconds for an overnight soak.
+
+// ---------------------------------------------------------------------------
+// Reference implementation: the simplest book that can be right. Linear
+// scans and whole-struct copies are fine — it only exists to disagree with
+// the engine when the engine is wrong.
+struct ReferenceBook {
+    struct RefOrder {
+        int orderID;
+        int quantity;
+    };
+
+    std::map<int, std::deque<RefOrder>> asks;                     // Ascending
+    std::map<int, std::deque<RefOrder>, std::greater<int>> bids;  // Descending
+    long limitFilled = 0;   // Quantity matched between resting orders
+    long marketFilled = 0;  // Resting quantity consumed by market orders
+
+    void add(Side side, int price, int quantity, int orderID) {
+        if (side == Side::ASK) {
+            asks[price].push_back(RefOrder{orderID, quantity});
+        } else {
+            bids[price].push_back(RefOrder{orderID, quantity});
+        }
+    }
+
+    template <typename Ladder>
+    bool cancelIn(Ladder& ladder, int orderID) {
+        for (typename Ladder::iterator levelIt = ladder.begin(); levelIt != ladder.end(); ++levelIt) {
+            for (typename std::deque<RefOrder>::iterator it = levelIt->second.begin();
+                 it != levelIt->second.end(); ++it) {
+                if (it->orderID == orderID) {
+                    levelIt->second.erase(it);
+                    if (levelIt->second.empty()) {
+                        ladder.erase(levelIt);
+                    }
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool cancel(int orderID) {
+        return cancelIn(asks, orderID) || cancelIn(bids, orderID);
+    }
+
+    // Pair best bid and best ask until the book no longer crosses
+    void match() {
+        while (!asks.empty() && !bids.empty() && bids.begin()->first >= asks.begin()->first) {
+            RefOrder& ask = asks.begin()->second.front();
+            RefOrder& bid = bids.begin()->second.front();
+            int matched = std::min(ask.quantity, bid.quantity);
+            ask.quantity -= matched;
+            bid.quantity -= matched;
+            limitFilled += matched;
+            if (ask.quantity == 0) {
+                asks.begin()->second.pop_front();
+                if (asks.begin()->second.empty()) {
+                    asks.erase(asks.begin());
+                }
+            }
+            if (bid.quantity == 0) {
+                bids.begin()->second.pop_front();
+                if (bids.begin()->second.empty()) {
+                    bids.erase(bids.begin());
+                }
+            }
+        }
+    }
+
+    template <typename Ladder>
+    void marketConsume(Ladder& ladder, int quantity) {
+        while (quantity > 0 && !ladder.empty()) {
+            RefOrder& top = ladder.begin()->second.front();
+            int matched = std::min(quantity, top.quantity);
+            top.quantity -= matched;
+            quantity -= matched;
+            marketFilled += matched;
+            if (top.quantity == 0) {
+                ladder.begin()->second.pop_front();
+                if (ladder.begin()->second.empty()) {
+                    ladder.erase(ladder.begin());
+                }
+            }
+        }
+    }
+
+    void marketBuy(int quantity) {
+        marketConsume(asks, quantity);
+    }
+
+    void marketSell(int quantity) {
+        marketConsume(bids, quantity);
+    }
+};
+
+// Compares one engine ladder against its reference counterpart order by
+// order; returns the number of differences found, reporting each
+template <typename EngineLadder, typename RefLadder>
+long compareSide(const OrderBookData& data, const EngineLadder& engineLadder,
+                 const RefLadder& refLadder, const char* name) {
+    long differences = 0;
+    typename EngineLadder::const_iterator engineIt = engineLadder.begin();
+    typename RefLadder::const_iterator refIt = refLadder.begin();
+    while (engineIt != engineLadder.end() && refIt != refLadder.end()) {
+        if (engineIt->first != refIt->first) {
+            std::cerr << name << " level mismatch: engine " << engineIt->first
+                      << " vs reference " << refIt->first << std::endl;
+            return differences + 1;  // Levels out of step; stop here
+        }
+        if (engineIt->second.size() != refIt->second.size()) {
+            std::cerr << name << " level " << engineIt->first << " has "
+                      << engineIt->second.size() << " orders, reference "
+                      << refIt->second.size() << std::endl;
+            differences++;
+        } else {
+            for (size_t i = 0; i < engineIt->second.size(); i++) {
+                const Order& order = data.getOrder(engineIt->second[i]);
+                const ReferenceBook::RefOrder& reference = refIt->second[i];
+                if (order.getOrderID() != reference.orderID || order.getQuantity() != reference.quantity) {
+                    std::cerr << name << " level " << engineIt->first << " slot " << i
+                              << ": engine ID " << order.getOrderID() << " x" << order.getQuantity()
+                              << ", reference ID " << reference.orderID << " x" << reference.quantity
+                              << std::endl;
+                    differences++;
+                }
+            }
+        }
+        ++engineIt;
+        ++refIt;
+    }
+    if (engineIt != engineLadder.end() || refIt != refLadder.end()) {
+        std::cerr << name << " side has different level counts" << std::endl;
+        differences++;
+    }
+    return differences;
+}
+
+// ---------------------------------------------------------------------------
+// Phase 1: concurrency soak
+
+struct SoakTotals {
+    std::atomic<long> placedQuantity{0};
+    std::atomic<long> placeCommands{0};
+    std::atomic<long> commandsSubmitted{0};
+};
+
+bool runSoak(int soakSeconds, int producers, int cancelPercent, bool persist) {
+    std::cout << "=== soak: " << producers << " producers, " << soakSeconds
+              << "s, " << cancelPercent << "% cancels, persistence "
+              << (persist ? "ON" : "OFF") << " ===" << std::endl;
+    SerialisationService::getInstance()->setPersistenceEnabled(persist);
+    MatchingEngine engine;
+    SoakTotals totals;
+    std::atomic<bool> stop{false};
+    std::atomic<long> crossedObservations{0};
+    std::atomic<long> viewReads{0};
+    std::atomic<long> limitFilled{0};
+    std::atomic<long> marketFilled{0};
+
+    // Continuously validates the published view: post-match snapshots must
+    // never show a crossed book
+    std::thread checker([&] {
+        const MarketDataView& view = engine.getMarketDataView();
+        while (!stop.load(std::memory_order_acquire)) {
+            OrderBookData::TopOfBook top = view.readTopOfBook();
+            if (top.bidPrice != 0 && top.askPrice != 0 && top.bidPrice >= top.askPrice) {
+                crossedObservations.fetch_add(1, std::memory_order_relaxed);
+            }
+            MarketDataView::DepthSnapshot depth = view.readDepth();
+            if (depth.bidLevels > 0 && depth.askLevels > 0
+                    && depth.bids[0].price >= depth.asks[0].price) {
+                crossedObservations.fetch_add(1, std::memory_order_relaxed);
+            }
+            viewReads.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    // Single consumer keeps the execution ring drained and accounts fills.
+    // A fill between two resting orders consumes quantity from both sides;
+    // a market fill (order ID 0 on one side) consumes only the resting side.
+    std::thread fillConsumer([&] {
+        ExecutionReportStream& stream = engine.getOrderBook().getExecutionStream();
+        ExecutionReport report;
+        while (!stop.load(std::memory_order_acquire)) {
+            bool drained = false;
+            while (stream.poll(report)) {
+                if (report.askOrderID != 0 && report.bidOrderID != 0) {
+                    limitFilled.fetch_add(report.quantity, std::memory_order_relaxed);
+                } else {
+                    marketFilled.fetch_add(report.quantity, std::memory_order_relaxed);
+                }
+                drained = true;
+            }
+            if (!drained) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // The sequencer carries on across soak passes, so cancel guesses need
+    // the base of the ID range this pass will actually use; a probe order
+    // placed before any producer starts donates it, and its quantity is
+    // accounted like any other placement
+    int idBase = engine.getOrderBook().placeBid(1, 1);
+    totals.placedQuantity.fetch_add(1, std::memory_order_relaxed);
+
+    // Cancel misses log through std::cout on the matching thread; suppress
+    // them for the duration, the way bench and replay do
+    std::cout.setstate(std::ios::failbit);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(soakSeconds);
+    std::vector<std::thread> producerThreads;
+    for (int producer = 0; producer < producers; producer++) {
+        producerThreads.emplace_back([&, producer] {
+            std::mt19937 rng(1000 + producer);
+            std::uniform_int_distribution<int> opDist(0, 99);
+            std::uniform_int_distribution<int> priceDist(80, 120);
+            std::uniform_int_distribution<int> quantityDist(1, 50);
+            while (std::chrono::steady_clock::now() < deadline) {
+                OrderCommand command{};
+                int op = opDist(rng);
+                if (op < cancelPercent && totals.placeCommands.load(std::memory_order_relaxed) > 0) {
+                    command.type = OrderCommand::CANCEL;
+                    // IDs are not echoed back through the ring, so target the
+                    // range the sequencer is handing out; misses are no-ops
+                    std::uniform_int_distribution<long> idDist(idBase,
+                            idBase + totals.placeCommands.load(std::memory_order_relaxed) + 4096);
+                    command.orderID = static_cast<int>(idDist(rng));
+                } else if (op < cancelPercent + 10) {
+                    command.type = (op % 2) ? OrderCommand::MARKET_BUY : OrderCommand::MARKET_SELL;
+                    command.quantity = quantityDist(rng);
+                } else {
+                    command.type = OrderCommand::PLACE;
+                    command.side = (op % 2) ? Side::ASK : Side::BID;
+                    command.price = priceDist(rng);
+                    command.quantity = quantityDist(rng);
+                    totals.placedQuantity.fetch_add(command.quantity, std::memory_order_relaxed);
+                    totals.placeCommands.fetch_add(1, std::memory_order_relaxed);
+                }
+                engine.submitShared(command);
+                totals.commandsSubmitted.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (std::thread& producerThread : producerThreads) {
+        producerThread.join();
+    }
+    // waitUntilIdle guarantees the final batch has been matched and
+    // published, so the book is quiescent from here; leave the consumer a
+    // moment to drain the last fills
+    engine.waitUntilIdle();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    stop.store(true, std::memory_order_release);
+    checker.join();
+    fillConsumer.join();
+    std::cout.clear();
+
+    // Final accounting against the quiesced book (the matching thread only
+    // spins on its empty ring from here, the same pattern the interactive
+    // display relies on)
+    OrderBookData& data = engine.getOrderBook().getOrderBookData();
+    ExecutionReport report;
+    while (engine.getOrderBook().getExecutionStream().poll(report)) {
+        if (report.askOrderID != 0 && report.bidOrderID != 0) {
+            limitFilled.fetch_add(report.quantity, std::memory_order_relaxed);
+        } else {
+            marketFilled.fetch_add(report.quantity, std::memory_order_relaxed);
+        }
+    }
+    uint64_t droppedFills = engine.getOrderBook().getExecutionStream().getDroppedFills();
+
+    long restingQuantity = 0;
+    std::set<int> restingIDs;
+    long duplicateIDs = 0;
+    auto walkSide = [&](const auto& ladder) {
+        for (const auto& level : ladder) {
+            for (OrderHandle handle : level.second) {
+                const Order& order = data.getOrder(handle);
+                restingQuantity += order.getQuantity();
+                if (!restingIDs.insert(order.getOrderID()).second) {
+                    duplicateIDs++;
+                }
+            }
+        }
+    };
+    walkSide(data.getAskLadder());
+    walkSide(data.getBidLadder());
+
+    // Conservation: every placed unit is either still resting, was consumed
+    // by a fill (both sides for limit fills, one for market), or was
+    // cancelled. Cancelled quantity is derived, so it must be non-negative,
+    // and zero exactly when no cancels were submitted.
+    long accountedQuantity = 2 * limitFilled.load() + marketFilled.load() + restingQuantity;
+    long derivedCancelled = totals.placedQuantity.load() - accountedQuantity;
+
+    // Index consistency: every resting order must be cancellable through
+    // the index, after which the book must be empty
+    std::cout.setstate(std::ios::failbit);
+    long indexMisses = 0;
+    for (int restingID : restingIDs) {
+        if (!engine.getOrderBook().cancel(restingID)) {
+            indexMisses++;
+        }
+    }
+    std::cout.clear();
+
+    bool passed = true;
+    std::cout << "commands=" << totals.commandsSubmitted.load()
+              << " (" << (totals.commandsSubmitted.load() / std::max(soakSeconds, 1)) << "/s)"
+              << " viewReads=" << viewReads.load()
+              << " limitFilled=" << limitFilled.load()
+              << " marketFilled=" << marketFilled.load()
+              << " resting=" << restingQuantity
+              << " derivedCancelled=" << derivedCancelled
+              << " droppedFills=" << droppedFills << std::endl;
+    if (crossedObservations.load() != 0) {
+        std::cerr << "FAIL: view showed a crossed book " << crossedObservations.load() << " times" << std::endl;
+        passed = false;
+    }
+    if (duplicateIDs != 0) {
+        std::cerr << "FAIL: " << duplicateIDs << " duplicate order IDs resting" << std::endl;
+        passed = false;
+    }
+    if (droppedFills == 0) {
+        if (derivedCancelled < 0) {
+            std::cerr << "FAIL: conservation violated, " << -derivedCancelled
+                      << " units of quantity appeared from nowhere" << std::endl;
+            passed = false;
+        }
+        if (cancelPercent == 0 && derivedCancelled != 0) {
+            std::cerr << "FAIL: " << derivedCancelled
+                      << " units unaccounted for with no cancels submitted" << std::endl;
+            passed = false;
+        }
+    } else {
+        std::cout << "note: " << droppedFills << " fills overran the ring; conservation not checkable" << std::endl;
+    }
+    if (indexMisses != 0) {
+        std::cerr << "FAIL: " << indexMisses << " resting orders not cancellable via the index" << std::endl;
+        passed = false;
+    }
+    if (data.getOrderCount() != 0) {
+        std::cerr << "FAIL: " << data.getOrderCount() << " orders left after cancelling everything" << std::endl;
+        passed = false;
+    }
+    return passed;
+}
+
+// ---------------------------------------------------------------------------
+// Phase 2: deterministic semantics cross-check against the reference book
+
+bool runCrossCheck(int commands) {
+    std::cout << "=== cross-check: " << commands << " commands vs reference ===" << std::endl;
+    OrderBook engineBook;
+    ReferenceBook referenceBook;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> opDist(0, 99);
+    std::uniform_int_distribution<int> priceDist(90, 110);
+    std::uniform_int_distribution<int> quantityDist(1, 30);
+    std::vector<int> knownIDs;
+    long cancelDisagreements = 0;
+
+    std::cout.setstate(std::ios::failbit);
+    for (int i = 0; i < commands; i++) {
+        int op = opDist(rng);
+        if (op < 20 && !knownIDs.empty()) {
+            // Both books attempt the same cancel; the target may already be
+            // filled, and the two must agree on whether it still exists
+            std::uniform_int_distribution<size_t> pick(0, knownIDs.size() - 1);
+            int target = knownIDs[pick(rng)];
+            bool engineOK = engineBook.cancel(target);
+            bool referenceOK = referenceBook.cancel(target);
+            if (engineOK != referenceOK) {
+                cancelDisagreements++;
+            }
+        } else if (op < 30) {
+            int quantity = quantityDist(rng);
+            if (op % 2) {
+                engineBook.marketBuy(quantity);
+                referenceBook.marketBuy(quantity);
+            } else {
+                engineBook.marketSell(quantity);
+                referenceBook.marketSell(quantity);
+            }
+        } else {
+            Side side = (op % 2) ? Side::ASK : Side::BID;
+            int price = priceDist(rng);
+            int quantity = quantityDist(rng);
+            int orderID = (side == Side::ASK) ? engineBook.placeAsk(price, quantity)
+                                              : engineBook.placeBid(price, quantity);
+            referenceBook.add(side, price, quantity, orderID);
+            knownIDs.push_back(orderID);
+        }
+        // Match after every command so both books uncross at the same points
+        engineBook.matchBidAsk();
+        referenceBook.match();
+    }
+    std::cout.clear();
+
+    // Account the engine's fills off its execution stream
+    long engineLimitFilled = 0;
+    long engineMarketFilled = 0;
+    ExecutionReport report;
+    while (engineBook.getExecutionStream().poll(report)) {
+        if (report.askOrderID != 0 && report.bidOrderID != 0) {
+            engineLimitFilled += report.quantity;
+        } else {
+            engineMarketFilled += report.quantity;
+        }
+    }
+
+    const OrderBookData& data = engineBook.getOrderBookData();
+    long differences = compareSide(data, data.getAskLadder(), referenceBook.asks, "ask");
+    differences += compareSide(data, data.getBidLadder(), referenceBook.bids, "bid");
+
+    bool passed = true;
+    std::cout << "limitFilled engine=" << engineLimitFilled << " reference=" << referenceBook.limitFilled
+              << ", marketFilled engine=" << engineMarketFilled << " reference=" << referenceBook.marketFilled
+              << ", resting=" << data.getOrderCount() << std::endl;
+    if (differences != 0) {
+        std::cerr << "FAIL: " << differences << " book differences vs reference" << std::endl;
+        passed = false;
+    }
+    if (cancelDisagreements != 0) {
+        std::cerr << "FAIL: " << cancelDisagreements << " cancel outcome disagreements" << std::endl;
+        passed = false;
+    }
+    if (engineLimitFilled != referenceBook.limitFilled || engineMarketFilled != referenceBook.marketFilled) {
+        std::cerr << "FAIL: fill totals differ from reference" << std::endl;
+        passed = false;
+    }
+    return passed;
+}
+
+// ---------------------------------------------------------------------------
+// Directed time-in-force cases: the IOC/FOK placement path bypasses the
+// resting-book structures entirely, so the generic cross-check never
+// exercises it
+
+bool runTimeInForceChecks() {
+    std::cout << "=== time-in-force checks ===" << std::endl;
+    OrderBook book;
+    long failures = 0;
+    auto expect = [&failures](bool condition, const char* what) {
+        if (!condition) {
+            std::cerr << "FAIL: " << what << std::endl;
+            failures++;
+        }
+    };
+
+    // GTC rests in full and reports nothing filled
+    expect(book.placeOrder(Side::BID, 90, 10, TimeInForce::GTC) == 0, "GTC reported a fill");
+    expect(book.getOrderBookData().getOrderCount() == 1, "GTC did not rest");
+
+    // FOK against insufficient quantity is killed without touching the book
+    book.placeOrder(Side::ASK, 105, 10, TimeInForce::GTC);
+    expect(book.placeOrder(Side::BID, 105, 20, TimeInForce::FOK) == 0, "underfilled FOK filled");
+    expect(book.getOrderBookData().availableQuantity(Side::BID, 105) == 10, "killed FOK touched the book");
+
+    // FOK with enough resting quantity fills completely
+    expect(book.placeOrder(Side::BID, 105, 10, TimeInForce::FOK) == 10, "covered FOK did not fill in full");
+    expect(book.getOrderBookData().bestAskEmpty(), "filled FOK left its contra resting");
+
+    // IOC fills what crosses and drops the rest instead of resting it
+    book.placeOrder(Side::ASK, 105, 5, TimeInForce::GTC);
+    expect(book.placeOrder(Side::BID, 106, 8, TimeInForce::IOC) == 5, "IOC did not fill the crossing quantity");
+    expect(book.getOrderBookData().bestAskEmpty(), "IOC left filled contra resting");
+    expect(book.getOrderBookData().getOrderCount() == 1, "IOC remainder rested");
+
+    // An IOC that crosses nothing is a pure no-op: no fill, no rest, and no
+    // sequencer ID consumed — the next placed order's ID stays contiguous
+    int before = book.placeBid(50, 1);
+    expect(book.placeOrder(Side::BID, 40, 5, TimeInForce::IOC) == 0, "uncrossed IOC filled");
+    int after = book.placeBid(50, 1);
+    expect(after == before + 1, "uncrossed IOC consumed an order ID");
+
+    if (failures == 0) {
+        std::cout << "all time-in-force cases passed" << std::endl;
+    }
+    return failures == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Auction uncross: randomised books checked against a reference
+// computation of the single uncrossing price over the ReferenceBook maps
+
+// Reference uncross: for every candidate level price in the crossing range,
+// tally cumulative supply (asks at or below) and demand (bids at or above)
+// the slow, obvious way and pick the volume-maximising price, breaking ties
+// by smaller imbalance and then lowest price — the semantics endAuction's
+// merged single-pass walk must reproduce. Returns {price, volume}, {0, 0}
+// when nothing crosses.
+std::pair<int, long> referenceUncross(const ReferenceBook& referenceBook) {
+    if (referenceBook.asks.empty() || referenceBook.bids.empty()) {
+        return {0, 0};
+    }
+    int bestAsk = referenceBook.asks.begin()->first;
+    int bestBid = referenceBook.bids.begin()->first;
+    if (bestBid < bestAsk) {
+        return {0, 0};
+    }
+    std::set<int> candidates;
+    for (const auto& level : referenceBook.asks) {
+        if (level.first <= bestBid) {
+            candidates.insert(level.first);
+        }
+    }
+    for (const auto& level : referenceBook.bids) {
+        if (level.first >= bestAsk) {
+            candidates.insert(level.first);
+        }
+    }
+    int bestPrice = 0;
+    long bestVolume = 0;
+    long bestImbalance = 0;
+    for (int price : candidates) {  // Ascending, so ties keep the lowest price
+        long supply = 0;
+        long demand = 0;
+        for (const auto& level : referenceBook.asks) {
+            if (level.first <= price) {
+                for (const ReferenceBook::RefOrder& order : level.second) {
+                    supply += order.quantity;
+                }
+            }
+        }
+        for (const auto& level : referenceBook.bids) {
+            if (level.first >= price) {
+                for (const ReferenceBook::RefOrder& order : level.second) {
+                    demand += order.quantity;
+                }
+            }
+        }
+        long volume = std::min(supply, demand);
+        long imbalance = (supply > demand) ? supply - demand : demand - supply;
+        if (volume > bestVolume || (volume == bestVolume && volume > 0 && imbalance < bestImbalance)) {
+            bestPrice = price;
+            bestVolume = volume;
+            bestImbalance = imbalance;
+        }
+    }
+    return {bestPrice, bestVolume};
+}
+
+bool runAuctionChecks(int scenarios) {
+    std::cout << "=== auction uncross checks: " << scenarios << " scenarios ===" << std::endl;
+    long failures = 0;
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> priceDist(95, 105);
+    std::uniform_int_distribution<int> quantityDist(1, 20);
+    std::uniform_int_distribution<int> sideDist(0, 1);
+    std::uniform_int_distribution<int> countDist(10, 60);
+
+    for (int scenario = 0; scenario < scenarios; scenario++) {
+        OrderBook book;
+        ReferenceBook referenceBook;
+        book.beginAuction();
+        int orders = countDist(rng);
+        for (int i = 0; i < orders; i++) {
+            Side side = sideDist(rng) ? Side::ASK : Side::BID;
+            int price = priceDist(rng);
+            int quantity = quantityDist(rng);
+            int orderID = (side == Side::ASK) ? book.placeAsk(price, quantity)
+                                              : book.placeBid(price, quantity);
+            referenceBook.add(side, price, quantity, orderID);
+        }
+
+        std::pair<int, long> expected = referenceUncross(referenceBook);
+        OrderBook::AuctionResult result = book.endAuction();
+        if (result.uncrossingPrice != expected.first || result.matchedVolume != expected.second) {
+            std::cerr << "FAIL: scenario " << scenario << " uncrossed at "
+                      << result.uncrossingPrice << "x" << result.matchedVolume
+                      << ", reference says " << expected.first << "x" << expected.second << std::endl;
+            failures++;
+        }
+
+        // Every fill must print at the single uncrossing price and the
+        // reported volume must add up to the auction result
+        long reportedVolume = 0;
+        ExecutionReport report;
+        while (book.getExecutionStream().poll(report)) {
+            if (report.price != result.uncrossingPrice) {
+                std::cerr << "FAIL: scenario " << scenario << " filled at "
+                          << report.price << ", not the uncrossing price" << std::endl;
+                failures++;
+            }
+            reportedVolume += report.quantity;
+        }
+        if (reportedVolume != result.matchedVolume) {
+            std::cerr << "FAIL: scenario " << scenario << " reported " << reportedVolume
+                      << " of " << result.matchedVolume << " matched" << std::endl;
+            failures++;
+        }
+
+        // The residual book must be uncrossed
+        const OrderBookData& data = book.getOrderBookData();
+        if (!data.getAskLadder().empty() && !data.getBidLadder().empty()
+                && data.getBidLadder().begin()->first >= data.getAskLadder().begin()->first) {
+            std::cerr << "FAIL: scenario " << scenario << " left a crossed book" << std::endl;
+            failures++;
+        }
+    }
+    if (failures == 0) {
+        std::cout << "all auction scenarios passed" << std::endl;
+    }
+    return failures == 0;
+}
+
+// ---------------------------------------------------------------------------
+// CSV interchange: export a book, bulk-load it back, and require the loaded
+// book to be identical, with the ID sequencer raised past every imported ID
+
+// Walks two ladders of the same ordering in lockstep; returns differences
+template <typename Ladder>
+long compareLadders(const OrderBookData& a, const Ladder& ladderA,
+                    const OrderBookData& b, const Ladder& ladderB, const char* name) {
+    long differences = 0;
+    typename Ladder::const_iterator itA = ladderA.begin();
+    typename Ladder::const_iterator itB = ladderB.begin();
+    while (itA != ladderA.end() && itB != ladderB.end()) {
+        if (itA->first != itB->first || itA->second.size() != itB->second.size()) {
+            std::cerr << name << " level mismatch at " << itA->first << "/" << itB->first << std::endl;
+            return differences + 1;
+        }
+        for (size_t i = 0; i < itA->second.size(); i++) {
+            const Order& orderA = a.getOrder(itA->second[i]);
+            const Order& orderB = b.getOrder(itB->second[i]);
+            if (orderA.getOrderID() != orderB.getOrderID()
+                    || orderA.getQuantity() != orderB.getQuantity()) {
+                std::cerr << name << " level " << itA->first << " slot " << i << " differs" << std::endl;
+                differences++;
+            }
+        }
+        ++itA;
+        ++itB;
+    }
+    if (itA != ladderA.end() || itB != ladderB.end()) {
+        std::cerr << name << " side has different level counts" << std::endl;
+        differences++;
+    }
+    return differences;
+}
+
+bool runInterchangeChecks() {
+    std::cout << "=== csv interchange checks ===" << std::endl;
+    long failures = 0;
+    auto expect = [&failures](bool condition, const char* what) {
+        if (!condition) {
+            std::cerr << "FAIL: " << what << std::endl;
+            failures++;
+        }
+    };
+    SerialisationService* serialiser = SerialisationService::getInstance();
+
+    // A non-crossing book with several orders per level round-trips exactly,
+    // time priority included
+    OrderBook book;
+    for (int i = 0; i < 200; i++) {
+        book.placeBid(90 - (i % 10), 1 + i % 7);
+        book.placeAsk(101 + (i % 10), 1 + i % 5);
+    }
+    serialiser->exportCSV(book.getOrderBookData(), "interchange.csv");
+
+    OrderBookData imported;
+    expect(serialiser->importCSV(imported, "interchange.csv") == 400,
+           "importCSV did not load every exported order");
+    long differences = compareLadders(book.getOrderBookData(), book.getOrderBookData().getAskLadder(),
+                                      imported, imported.getAskLadder(), "imported ask");
+    differences += compareLadders(book.getOrderBookData(), book.getOrderBookData().getBidLadder(),
+                                  imported, imported.getBidLadder(), "imported bid");
+    expect(differences == 0, "imported book differs from the exported one");
+
+    // Importing IDs above the sequencer's floor must raise it: an order
+    // placed afterwards may never reuse an imported ID
+    const int farID = 50000000;
+    std::ofstream farFile("far_ids.csv");
+    farFile << "B,60,1," << farID << "\n";
+    farFile.close();
+    OrderBookData farBook;
+    expect(serialiser->importCSV(farBook, "far_ids.csv") == 1, "far-ID import failed");
+    OrderBook placedAfter;
+    expect(placedAfter.placeBid(50, 1) > farID, "order placed after import reused an imported ID range");
+
+    if (failures == 0) {
+        std::cout << "all interchange cases passed" << std::endl;
+    }
+    return failures == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Multi-book engine: deterministic non-crossing flow routed across several
+// symbols, verified through each shard book's own persistence stream
+
+bool runMultiBookChecks() {
+    std::cout << "=== multi-book engine checks ===" << std::endl;
+    const int symbolCount = 6;
+    const int totalCommands = 6000;
+    long failures = 0;
+
+    std::vector<std::string> symbols;
+    for (int s = 0; s < symbolCount; s++) {
+        symbols.push_back("SYM" + std::to_string(s));
+    }
+    // Shard books assign IDs from their own fresh sequencers, so with a
+    // single router the i-th order placed on a symbol is predictably ID i+1;
+    // that lets the reference mirror cancels exactly. The flow never
+    // crosses, so shard matching cadence cannot change the final books.
+    std::vector<ReferenceBook> references(symbolCount);
+    std::vector<int> lastID(symbolCount, 0);
+    std::vector<std::vector<int>> liveIDs(symbolCount);
+    std::mt19937 rng(23);
+    std::uniform_int_distribution<int> opDist(0, 99);
+    std::uniform_int_distribution<int> bidPriceDist(80, 95);
+    std::uniform_int_distribution<int> askPriceDist(105, 120);
+    std::uniform_int_distribution<int> quantityDist(1, 30);
+
+    std::cout.setstate(std::ios::failbit);
+    {
+        MultiBookEngine engine(3);
+        for (int i = 0; i < totalCommands; i++) {
+            int s = i % symbolCount;
+            OrderCommand command{};
+            int op = opDist(rng);
+            if (op < 15 && !liveIDs[s].empty()) {
+                std::uniform_int_distribution<size_t> pick(0, liveIDs[s].size() - 1);
+                size_t slot = pick(rng);
+                command.type = OrderCommand::CANCEL;
+                command.orderID = liveIDs[s][slot];
+                references[s].cancel(command.orderID);
+                liveIDs[s].erase(liveIDs[s].begin() + slot);
+            } else {
+                command.type = OrderCommand::PLACE;
+                command.side = (op % 2) ? Side::ASK : Side::BID;
+                command.price = (command.side == Side::ASK) ? askPriceDist(rng) : bidPriceDist(rng);
+                command.quantity = quantityDist(rng);
+                command.orderID = 0;
+                int predictedID = ++lastID[s];
+                references[s].add(command.side, command.price, command.quantity, predictedID);
+                liveIDs[s].push_back(predictedID);
+            }
+            engine.submit(symbols[s], command);
+        }
+        engine.waitUntilIdle();
+    }  // Destroying the engine snapshots every shard book through its stream
+    std::cout.clear();
+
+    // Recover each symbol's book from its own files and compare it against
+    // the reference order by order — this covers the shard routing, the
+    // per-symbol ID sequencing and the named persistence streams in one go
+    for (int s = 0; s < symbolCount; s++) {
+        std::unique_ptr<SerialisationService> stream(SerialisationService::createNamed(symbols[s]));
+        OrderBook recovered(stream.get());
+        const OrderBookData& data = recovered.getOrderBookData();
+        long differences = compareSide(data, data.getAskLadder(), references[s].asks, "recovered ask");
+        differences += compareSide(data, data.getBidLadder(), references[s].bids, "recovered bid");
+        if (differences != 0) {
+            std::cerr << "FAIL: symbol " << symbols[s] << " recovered with "
+                      << differences << " differences" << std::endl;
+            failures++;
+        }
+    }
+    if (failures == 0) {
+        std::cout << "all " << symbolCount << " symbols recovered identical to reference" << std::endl;
+    }
+    return failures == 0;
+}
+
+int main(int argc, char *argv[]) {
+    int soakSeconds = 10;
+    int producers = 4;
+    int cancelPercent = 20;
+    int crossCheckCommands = 50000;
+    if (argc > 1) {
+        soakSeconds = std::stoi(argv[1]);
+    }
+    if (argc > 2) {
+        producers = std::stoi(argv[2]);
+    }
+    if (argc > 3) {
+        cancelPercent = std::stoi(argv[3]);
+    }
+    if (argc > 4) {
+        crossCheckCommands = std::stoi(argv[4]);
+    }
+
+    // Run in a scratch directory so the harness never touches a real book's
+    // files; this must precede the first getInstance() call, which opens the
+    // singleton's log streams in the current directory
+    char scratchDir[] = "/tmp/orderbook_stress_XXXXXX";
+    if (mkdtemp(scratchDir) != nullptr) {
+        if (chdir(scratchDir) != 0) {
+            std::cerr << "Unable to enter scratch directory " << scratchDir << std::endl;
+        }
+    }
+    SerialisationService::getInstance()->setPersistenceEnabled(false);
+
+    // Soak twice, the way bench measures both modes: once with the engine
+    // alone, once with the async persistence pipeline underneath it
+    bool passed = runSoak(soakSeconds, producers, cancelPercent, false);
+    passed = runSoak(soakSeconds, producers, cancelPercent, true) && passed;
+    SerialisationService::getInstance()->setPersistenceEnabled(false);
+    passed = runCrossCheck(crossCheckCommands) && passed;
+    passed = runTimeInForceChecks() && passed;
+    passed = runInterchangeChecks() && passed;
+    passed = runAuctionChecks(200) && passed;
+    passed = runMultiBookChecks() && passed;
+
+    std::cout << (passed ? "\nSTRESS PASS" : "\nSTRESS FAIL") << std::endl;
+    return passed ? 0 : 1;
+}